@@ -9,6 +9,23 @@ namespace DD{
     IT count;
   };
 
+  // find the PET whose interval holds seqInd via bisection, -1 if none. The
+  // intervals are contiguous and in ascending order, and may be empty.
+  template<typename IT, typename ST> inline int intervalPet(
+    Interval<IT> const *interval, int petCount, ST seqInd){
+    if (petCount < 1 || seqInd < interval[0].min
+      || seqInd > interval[petCount-1].max) return -1;
+    int iMin=0, iMax=petCount-1;
+    while (iMin < iMax){
+      int i = iMin + (iMax - iMin) / 2;
+      if (interval[i].max < seqInd)
+        iMin = i + 1;
+      else
+        iMax = i;
+    }
+    return iMin;
+  }
+  
   template<typename IT> struct SeqIndexFactorLookup{
     vector<int> de;
     vector<FactorElement<SeqIndex<IT> > > factorList;
@@ -25,6 +42,7 @@ namespace DD{
       &linSeqVect;
     vector<SeqIndexFactorLookup<IT1> > &seqIndexFactorLookup;
     int localPet;
+    int petCount;
     int localDeCount;
     const int *localDeElementCount;
     const Interval<IT1> *seqIndexInterval;
@@ -47,6 +65,7 @@ namespace DD{
     const Interval<IT1> *seqIndexIntervalIn;
     const Interval<IT2> *seqIndexIntervalOut;
     int localPet;
+    int petCount;
     bool tensorMixFlag;
   public:
     FillPartnerDeInfo(
@@ -65,7 +84,7 @@ template<typename T>
 int requestSizeFactor(T *t);
 
 template<typename T>
-void clientRequest(T *t, int i, char **requestStreamClient);
+void clientRequest(T *t, char **requestStreamClient);
 
 template<typename T>
 void localClientServerExchange(T *t);
@@ -125,15 +144,19 @@ void accessLookup(
   }
   // localPet acts as a client, sends its requests to the appropriate servers
 //ESMC_LogDefault.Write("accessLookup: step 2", ESMC_LOGMSG_DEBUG); 
+  for (int i=0; i<petCount; i++){
+    requestStreamClient[i] = NULL;
+    if (i!=localPet && localElementsPerIntervalCount[i]>0)
+      requestStreamClient[i] =
+        new char[requestFactor*localElementsPerIntervalCount[i]];
+  }
+  // t-specific client routine fills the requests for all servers in one pass
+  clientRequest(t, requestStreamClient);
   for (int ii=localPet+petCount-1; ii>localPet; ii--){
     // localPet-dependent shifted loop reduces communication contention
     int i = ii%petCount;  // fold back into [0,..,petCount-1] range
     if (localElementsPerIntervalCount[i]>0){
       // localPet has elements that are located in interval of server Pet "i"
-      requestStreamClient[i] =
-        new char[requestFactor*localElementsPerIntervalCount[i]];
-      // t-specific client routine
-      clientRequest(t, i, requestStreamClient);
       // send information to the serving Pet
       send1commhList[i] = NULL;
 //sprintf(msg, "posting nb-send to PET %d size=%d", i, requestFactor*localElementsPerIntervalCount[i]);
@@ -161,20 +184,43 @@ void accessLookup(
   localClientServerExchange(t);
   // localPet acts as server, processing requests from clients, send response sz
 //ESMC_LogDefault.Write("accessLookup: step 4", ESMC_LOGMSG_DEBUG); 
+  vector<int> clientList;
   for (int ii=localPet+1; ii<localPet+petCount; ii++){
     // localPet-dependent shifted loop reduces communication contention
     int i = ii%petCount;  // fold back into [0,..,petCount-1] range
-    int count = localIntervalPerPetCount[i];
-    if (count>0){
+    if (localIntervalPerPetCount[i]>0){
       // wait for request from Pet "i"
 //sprintf(msg, "waiting on nb-recv for message from PET %d", i);
 //ESMC_LogDefault.Write(msg, ESMC_LOGMSG_DEBUG); 
       vm->commwait(&(recv3commhList[i]));
-      // t-specific server routine
-      int responseStreamSize =
-        serverResponseSize(t, count, i, requestStreamServer);
+      clientList.push_back(i);
+    }
+  }
+  // the responses to the different clients are independent of each other and
+  // only read the lookup table -> construct them in parallel
+  int clientCount = clientList.size();
+#ifndef ESMF_NO_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(vm->getLocalThreadCount())
+#endif
+  for (int k=0; k<clientCount; k++){
+    int i = clientList[k];
+    int count = localIntervalPerPetCount[i];
+    // t-specific server routines
+    int responseStreamSize =
+      serverResponseSize(t, count, i, requestStreamServer);
+    responseStreamSizeServer[i] = responseStreamSize;
+    if (responseStreamSize>0){
+      // construct response stream
+      responseStreamServer[i] = new char[responseStreamSize];
+      serverResponse(t, count, i, requestStreamServer, responseStreamServer);
+    }
+  }
+  for (int ii=localPet+1; ii<localPet+petCount; ii++){
+    // localPet-dependent shifted loop reduces communication contention
+    int i = ii%petCount;  // fold back into [0,..,petCount-1] range
+    int count = localIntervalPerPetCount[i];
+    if (count>0){
       // send response size to client Pet "i"
-      responseStreamSizeServer[i] = responseStreamSize;
       send2commhList[i] = NULL;
 //sprintf(msg, "posting nb-send to PET %d size=%d", i, sizeof(int));
 //ESMC_LogDefault.Write(msg, ESMC_LOGMSG_DEBUG); 
@@ -218,10 +264,6 @@ void accessLookup(
     if (count>0){
       int responseStreamSize = responseStreamSizeServer[i];
       if (responseStreamSize>0){
-        // construct response stream
-        responseStreamServer[i] = new char[responseStreamSize];
-        // t-specific server routine
-        serverResponse(t, count, i, requestStreamServer, responseStreamServer);
         // send response stream to client Pet "i"
         send3commhList[i] = NULL;
 //sprintf(msg, "posting nb-send to PET %d size=%d", i, responseStreamSize);
@@ -321,38 +363,41 @@ template<typename IT1, typename IT2>
 
 template<typename IT1, typename IT2> 
   void clientRequest(FillLinSeqVectInfo<IT1,IT2> *fillLinSeqVectInfo, 
-  int dstPet, char **requestStreamClient){
+  char **requestStreamClient){
+  const int localPet = fillLinSeqVectInfo->localPet;
+  const int petCount = fillLinSeqVectInfo->petCount;
   const int localDeCount = fillLinSeqVectInfo->localDeCount;
-  const int *localDeElementCount = fillLinSeqVectInfo->localDeElementCount;
   const Interval<IT1> *seqIndexInterval = fillLinSeqVectInfo->seqIndexInterval;
   const bool tensorMixFlag = fillLinSeqVectInfo->tensorMixFlag;
-  // fill the requestStreamClient[dstPet] element
-  int *requestStreamClientInt = (int *)requestStreamClient[dstPet];
-  IT1 seqIndMin = seqIndexInterval[dstPet].min;
-  IT1 seqIndMax = seqIndexInterval[dstPet].max;
-  IT1 seqIndCount = seqIndexInterval[dstPet].count;
+  // fill the requestStreamClient[] elements of all server Pets in a single
+  // pass over the local elements, locating the server Pet via bisection
+  vector<char *> requestStreamClientPos(requestStreamClient,
+    requestStreamClient+petCount);
   for (int j=0; j<localDeCount; j++){
     if (fillLinSeqVectInfo->haloRimFlag){
       // loop over the halo rim elements for localDe j
+      const std::vector<std::vector<SeqIndex<IT1> > > *rimSeqIndex;
+      fillLinSeqVectInfo->array->getRimSeqIndex(&rimSeqIndex);
       for (int k=0; k<fillLinSeqVectInfo->array->getRimElementCount()[j]; k++){
-        const std::vector<std::vector<SeqIndex<IT1> > > *rimSeqIndex;
-        fillLinSeqVectInfo->array->getRimSeqIndex(&rimSeqIndex);
         SeqIndex<IT1> seqIndex = (*rimSeqIndex)[j][k];
         if (seqIndex.valid()){
           IT1 seqInd = seqIndex.decompSeqIndex;
-          if (seqInd >= seqIndMin && seqInd <= seqIndMax){
-            int lookupIndex = (int)(seqInd - seqIndMin);
-            if (tensorMixFlag)
-              lookupIndex += (seqIndex.tensorSeqIndex - 1) * (int)seqIndCount;
-            *requestStreamClientInt++   = lookupIndex;
-            *requestStreamClientInt++   = j;
-            IT1 *requestStreamClientIT1 = (IT1 *)requestStreamClientInt;
-            *requestStreamClientIT1++   = seqIndex.decompSeqIndex;
-            requestStreamClientInt      = (int *)requestStreamClientIT1;
-            *requestStreamClientInt++   = seqIndex.tensorSeqIndex;
-            *requestStreamClientInt++   =
-              fillLinSeqVectInfo->array->getRimLinIndex()[j][k];
-          }
+          int dstPet = intervalPet(seqIndexInterval, petCount, seqInd);
+          if (dstPet < 0 || dstPet == localPet) continue;
+          int lookupIndex = (int)(seqInd - seqIndexInterval[dstPet].min);
+          if (tensorMixFlag)
+            lookupIndex += (seqIndex.tensorSeqIndex - 1)
+              * (int)seqIndexInterval[dstPet].count;
+          int *requestStreamClientInt = (int *)requestStreamClientPos[dstPet];
+          *requestStreamClientInt++   = lookupIndex;
+          *requestStreamClientInt++   = j;
+          IT1 *requestStreamClientIT1 = (IT1 *)requestStreamClientInt;
+          *requestStreamClientIT1++   = seqIndex.decompSeqIndex;
+          requestStreamClientInt      = (int *)requestStreamClientIT1;
+          *requestStreamClientInt++   = seqIndex.tensorSeqIndex;
+          *requestStreamClientInt++   =
+            fillLinSeqVectInfo->array->getRimLinIndex()[j][k];
+          requestStreamClientPos[dstPet] = (char *)requestStreamClientInt;
         }
       }
     }else{
@@ -362,10 +407,13 @@ template<typename IT1, typename IT2>
       while(arrayElement.isWithin()){
         SeqIndex<IT1> seqIndex = arrayElement.getSequenceIndex<IT1>();
         IT1 seqInd = seqIndex.decompSeqIndex;
-        if (seqInd >= seqIndMin && seqInd <= seqIndMax){
-          int lookupIndex = (int)(seqInd - seqIndMin);
+        int dstPet = intervalPet(seqIndexInterval, petCount, seqInd);
+        if (dstPet >= 0 && dstPet != localPet){
+          int lookupIndex = (int)(seqInd - seqIndexInterval[dstPet].min);
           if (tensorMixFlag)
-            lookupIndex += (seqIndex.tensorSeqIndex - 1) * (int)seqIndCount;
+            lookupIndex += (seqIndex.tensorSeqIndex - 1)
+              * (int)seqIndexInterval[dstPet].count;
+          int *requestStreamClientInt = (int *)requestStreamClientPos[dstPet];
           *requestStreamClientInt++   = lookupIndex;
           *requestStreamClientInt++   = j;
           IT1 *requestStreamClientIT1 = (IT1 *)requestStreamClientInt;
@@ -374,6 +422,7 @@ template<typename IT1, typename IT2>
           *requestStreamClientInt++   = seqIndex.tensorSeqIndex;
           *requestStreamClientInt++   =
             arrayElement.getLinearIndex();
+          requestStreamClientPos[dstPet] = (char *)requestStreamClientInt;
         }
         arrayElement.next();
       } // end while over all exclusive elements
@@ -578,48 +627,46 @@ template<typename IT1, typename IT2>
 }
 
 template<typename IT1, typename IT2>
-  void clientRequest(FillPartnerDeInfo<IT1,IT2> *fillPartnerDeInfo, int dstPet,
+  void clientRequest(FillPartnerDeInfo<IT1,IT2> *fillPartnerDeInfo,
   char **requestStreamClient){
   const int localPet = fillPartnerDeInfo->localPet;
+  const int petCount = fillPartnerDeInfo->petCount;
   const Interval<IT1> *seqIndexIntervalIn =
     fillPartnerDeInfo->seqIndexIntervalIn;
-  const Interval<IT2> *seqIndexIntervalOut =
-    fillPartnerDeInfo->seqIndexIntervalOut;
   vector<SeqIndexFactorLookup<IT2> > &seqIndexFactorLookupOut =
     fillPartnerDeInfo->seqIndexFactorLookupOut;
   const bool tensorMixFlag = fillPartnerDeInfo->tensorMixFlag;
-  // fill the requestStreamClient[dstPet] element
-  IT1 seqIndMin = seqIndexIntervalIn[dstPet].min;
-  IT1 seqIndMax = seqIndexIntervalIn[dstPet].max;
-  IT1 seqIndCount = seqIndexIntervalIn[dstPet].count;
-  int jj = 0; // reset
+  // fill the requestStreamClient[] elements of all server Pets in a single
+  // pass over the factors, locating the server Pet via bisection
+  vector<int> jj(petCount, 0); // reset
   int localLookupIndex = 0; // reset
   for (typename vector<DD::SeqIndexFactorLookup<IT2> >::const_iterator
     j=seqIndexFactorLookupOut.begin(); j!=seqIndexFactorLookupOut.end(); ++j){
     for (int k=0; k<j->factorCount; k++){
       IT2 partnerSeqInd = j->factorList[k]
         .partnerSeqIndex.decompSeqIndex;
-      if (partnerSeqInd >= seqIndMin && partnerSeqInd <= seqIndMax){
-        int lookupIndex = (int)(partnerSeqInd - seqIndMin);
-        if (tensorMixFlag){
-          lookupIndex += (j->factorList[k]
-            .partnerSeqIndex.tensorSeqIndex - 1) * (int)seqIndCount;
-        }
-        int *requestStreamClientInt = (int *)requestStreamClient[dstPet];
-        requestStreamClientInt[3*jj] = lookupIndex;
-        requestStreamClientInt[3*jj+1] = localLookupIndex;
-        requestStreamClientInt[3*jj+2] = k;
+      int dstPet = intervalPet(seqIndexIntervalIn, petCount, partnerSeqInd);
+      if (dstPet < 0 || dstPet == localPet) continue;
+      int lookupIndex = (int)(partnerSeqInd - seqIndexIntervalIn[dstPet].min);
+      if (tensorMixFlag){
+        lookupIndex += (j->factorList[k]
+          .partnerSeqIndex.tensorSeqIndex - 1)
+          * (int)seqIndexIntervalIn[dstPet].count;
+      }
+      int *requestStreamClientInt = (int *)requestStreamClient[dstPet];
+      int n = jj[dstPet]++;
+      requestStreamClientInt[3*n] = lookupIndex;
+      requestStreamClientInt[3*n+1] = localLookupIndex;
+      requestStreamClientInt[3*n+2] = k;
 #ifdef DEBUGLOG
-        {
-          std::stringstream debugmsg;
-          debugmsg << "clientRequest()#" << __LINE__ 
-            << " ,dstPet=" << dstPet
-            << "lookupIndex " << requestStreamClientInt[3*jj];
-          ESMC_LogDefault.Write(debugmsg.str(), ESMC_LOGMSG_DEBUG);
-        }
-#endif
-        ++jj; // increment counter
+      {
+        std::stringstream debugmsg;
+        debugmsg << "clientRequest()#" << __LINE__ 
+          << " ,dstPet=" << dstPet
+          << "lookupIndex " << requestStreamClientInt[3*n];
+        ESMC_LogDefault.Write(debugmsg.str(), ESMC_LOGMSG_DEBUG);
       }
+#endif
     }
     ++localLookupIndex;
   }
@@ -720,6 +767,7 @@ template<typename IT1, typename IT2>
   template<typename IT> class FillSelfDeInfo:public ComPat{
     Array const *array;
     int localPet;
+    int petCount;
     int localDeCount;
     int const *localDeElementCount;
     int const *localDeToDeMap;
@@ -729,10 +777,14 @@ template<typename IT1, typename IT2>
     int const *localIntervalPerPetCount;
     int const *localElementsPerIntervalCount;
     bool haloRimFlag;
+    // messages to all dstPets, prepared in a single pass on first request
+    mutable vector<vector<int> > preparedMessage;
+    mutable bool preparedFlag;
    public:
     FillSelfDeInfo(
       Array const *array_,
       int localPet_,
+      int petCount_,
       int localDeCount_,
       int const *localDeElementCount_,
       int const *localDeToDeMap_,
@@ -748,6 +800,7 @@ template<typename IT1, typename IT2>
     {
       array = array_;
       localPet = localPet_;
+      petCount = petCount_;
       localDeCount = localDeCount_;
       localDeElementCount = localDeElementCount_;
       localDeToDeMap = localDeToDeMap_;
@@ -756,6 +809,7 @@ template<typename IT1, typename IT2>
       localIntervalPerPetCount = localIntervalPerPetCount_;
       localElementsPerIntervalCount = localElementsPerIntervalCount_;
       haloRimFlag = haloRimFlag_;
+      preparedFlag = false;
     }
    private:
     int messageSizeCount(int srcPet, int dstPet)const{
@@ -770,51 +824,50 @@ template<typename IT1, typename IT2>
     virtual int messageSize(int srcPet, int dstPet)const{
       return 2 * sizeof(int) * messageSizeCount(srcPet, dstPet);
     }
-    virtual void messagePrepare(int srcPet, int dstPet, char *buffer)const{
-      IT seqIndMin = seqIndexInterval[dstPet].min;
-      IT seqIndMax = seqIndexInterval[dstPet].max;
-      IT seqIndCount = seqIndexInterval[dstPet].count;
-      int *bufferInt = (int *)buffer;
-      int jj = 0; // reset
+    void prepareAllMessages()const{
+      preparedMessage.resize(petCount);
+      for (int i=0; i<petCount; i++)
+        if (i!=localPet)
+          preparedMessage[i].reserve(2*localElementsPerIntervalCount[i]);
       for (int j=0; j<localDeCount; j++){
         int de = localDeToDeMap[j];  // global DE number
         if (haloRimFlag){
           // loop over the halo rim elements for localDe j
+          const std::vector<std::vector<SeqIndex<IT> > > *rimSeqIndex;
+          array->getRimSeqIndex(&rimSeqIndex);
           for (int k=0; k<array->getRimElementCount()[j]; k++){
-            const std::vector<std::vector<SeqIndex<IT> > > *rimSeqIndex;
-            array->getRimSeqIndex(&rimSeqIndex);
             SeqIndex<IT> seqIndex = (*rimSeqIndex)[j][k];
-            if (seqIndex.valid()){
-              IT seqInd = seqIndex.decompSeqIndex;
-              if (seqInd >= seqIndMin && seqInd <= seqIndMax){
-                int lookupIndex = (int)(seqInd - seqIndMin);
-                if (tensorMixFlag)
-                  lookupIndex += (seqIndex.tensorSeqIndex - 1)
-                  * (int)seqIndCount;
-                bufferInt[2*jj] = lookupIndex;
-                bufferInt[2*jj+1] = de;
-                ++jj; // increment counter
-              }
-            }
+            if (seqIndex.valid())
+              prepareElement(seqIndex, de);
           }
         }else{
           // loop over all elements in the exclusive region for localDe j
           ArrayElement arrayElement(array, j, true, false, false);
           while(arrayElement.isWithin()){
-            SeqIndex<IT> seqIndex = arrayElement.getSequenceIndex<IT>();
-            IT seqInd = seqIndex.decompSeqIndex;
-            if (seqInd >= seqIndMin && seqInd <= seqIndMax){
-              int lookupIndex = (int)(seqInd - seqIndMin);
-              if (tensorMixFlag)
-                lookupIndex += (seqIndex.tensorSeqIndex - 1) * (int)seqIndCount;
-              bufferInt[2*jj] = lookupIndex;
-              bufferInt[2*jj+1] = de;
-              ++jj; // increment counter
-            }
+            prepareElement(arrayElement.getSequenceIndex<IT>(), de);
             arrayElement.next();
           } // end while over all exclusive elements
         }
       }
+      preparedFlag = true;
+    }
+    void prepareElement(SeqIndex<IT> const &seqIndex, int de)const{
+      IT seqInd = seqIndex.decompSeqIndex;
+      int dstPet = intervalPet(seqIndexInterval, petCount, seqInd);
+      if (dstPet < 0 || dstPet == localPet) return;
+      int lookupIndex = (int)(seqInd - seqIndexInterval[dstPet].min);
+      if (tensorMixFlag)
+        lookupIndex += (seqIndex.tensorSeqIndex - 1)
+          * (int)seqIndexInterval[dstPet].count;
+      preparedMessage[dstPet].push_back(lookupIndex);
+      preparedMessage[dstPet].push_back(de);
+    }
+    virtual void messagePrepare(int srcPet, int dstPet, char *buffer)const{
+      if (!preparedFlag) prepareAllMessages();
+      vector<int> &message = preparedMessage[dstPet];
+      if (!message.empty())
+        memcpy(buffer, &message[0], message.size()*sizeof(int));
+      vector<int>().swap(message);  // release memory early
     }
     virtual void messageProcess(int srcPet, int dstPet, char *buffer){
       int count = messageSizeCount(srcPet, dstPet);
@@ -1400,12 +1453,17 @@ cout << "dstSetupFlag=" << dstSetupFlag << " tensorSeqIndex=" <<
 #endif
 
     // deal with duplicate sparse matrix entries in seqIndexFactorLookup
-    for (typename vector<SeqIndexFactorLookup<IT> >::iterator
-      i=seqIndexFactorLookup.begin(); i!=seqIndexFactorLookup.end(); ++i){
+    // entries are independent -> distribute them across the local threads
+    int lookupCount = (int)seqIndexFactorLookup.size();
+#ifndef ESMF_NO_OPENMP
+#pragma omp parallel for schedule(dynamic,1024) num_threads(vm->getLocalThreadCount())
+#endif
+    for (int ii=0; ii<lookupCount; ii++){
+      SeqIndexFactorLookup<IT> *i = &seqIndexFactorLookup[ii];
 #ifdef ASMM_STORE_LOG_on_disabled
       fprintf(asmm_store_log_fp,
         "befr duplicate elimination seqIndexFactorLookup[%d].factorCount=%d\n",
-        i-seqIndexFactorLookup.begin(), i->factorCount);
+        ii, i->factorCount);
 #endif
       sort(i->factorList.begin(), i->factorList.end());
       if (!haloFlag){
@@ -1431,7 +1489,7 @@ cout << "dstSetupFlag=" << dstSetupFlag << " tensorSeqIndex=" <<
 #ifdef ASMM_STORE_LOG_on_disabled
       fprintf(asmm_store_log_fp,
         "aftr duplicate elimination seqIndexFactorLookup[%d].factorCount=%d\n",
-        i-seqIndexFactorLookup.begin(), i->factorCount);
+        ii, i->factorCount);
 #endif
     }
     
@@ -1444,6 +1502,7 @@ cout << "dstSetupFlag=" << dstSetupFlag << " tensorSeqIndex=" <<
       DD::FillSelfDeInfo<IT> fillSelfDeInfo(
         array,
         localPet,
+        petCount,
         localDeCount,
         localDeElementCount,
         localDeToDeMap,
@@ -1462,8 +1521,11 @@ cout << "dstSetupFlag=" << dstSetupFlag << " tensorSeqIndex=" <<
 #endif
 
     // eliminate duplicate de entries in seqIndexFactorLookup
-    for (typename vector<SeqIndexFactorLookup<IT> >::iterator
-      i=seqIndexFactorLookup.begin(); i!=seqIndexFactorLookup.end(); ++i){
+#ifndef ESMF_NO_OPENMP
+#pragma omp parallel for schedule(dynamic,1024) num_threads(vm->getLocalThreadCount())
+#endif
+    for (int ii=0; ii<lookupCount; ii++){
+      SeqIndexFactorLookup<IT> *i = &seqIndexFactorLookup[ii];
       sort(i->de.begin(), i->de.end());
       i->de.erase(unique(i->de.begin(),i->de.end()),i->de.end());
     }
@@ -2075,22 +2137,19 @@ template<typename SIT, typename DIT> int sparseMatMulStoreLinSeqVect(
 
   // prepare count arrays for src partner look-up in dstSeqIndexFactorLookup
   int *srcLocalPartnerElementsPerIntervalCount = new int[petCount];
-  for (int i=0; i<petCount; i++){
-    // Pet "i" is the active srcSeqIndex interval
-    DIT seqIndexMin = dstSeqIndexInterval[i].min;
-    DIT seqIndexMax = dstSeqIndexInterval[i].max;
-    int count = 0; // reset
-    for (typename vector<DD::SeqIndexFactorLookup<SIT> >
-      ::const_iterator j=srcSeqIndexFactorLookup.begin(); 
-      j!=srcSeqIndexFactorLookup.end(); ++j){
-      for (int k=0; k<j->factorCount; k++){
-        SIT partnerSeqIndex = j->factorList[k]
-          .partnerSeqIndex.decompSeqIndex;
-        if (partnerSeqIndex >= seqIndexMin && partnerSeqIndex <= seqIndexMax)
-          ++count; // increment counter
-      }
+  for (int i=0; i<petCount; i++)
+    srcLocalPartnerElementsPerIntervalCount[i] = 0; // reset
+  // single pass over the factors, bisecting into the dstSeqIndex intervals
+  for (typename vector<DD::SeqIndexFactorLookup<SIT> >
+    ::const_iterator j=srcSeqIndexFactorLookup.begin(); 
+    j!=srcSeqIndexFactorLookup.end(); ++j){
+    for (int k=0; k<j->factorCount; k++){
+      SIT partnerSeqIndex = j->factorList[k]
+        .partnerSeqIndex.decompSeqIndex;
+      int i = DD::intervalPet(dstSeqIndexInterval, petCount, partnerSeqIndex);
+      if (i >= 0)
+        ++srcLocalPartnerElementsPerIntervalCount[i]; // increment counter
     }
-    srcLocalPartnerElementsPerIntervalCount[i] = count;
   }
   int *dstLocalPartnerIntervalPerPetCount = new int[petCount];
   vm->alltoall(srcLocalPartnerElementsPerIntervalCount, sizeof(int),
@@ -2107,6 +2166,7 @@ template<typename SIT, typename DIT> int sparseMatMulStoreLinSeqVect(
         (dstSeqIndexFactorLookup, srcSeqIndexFactorLookup);
       
     fillPartnerDeInfo->localPet = localPet;
+    fillPartnerDeInfo->petCount = petCount;
     fillPartnerDeInfo->seqIndexIntervalIn = dstSeqIndexInterval;
     fillPartnerDeInfo->seqIndexIntervalOut = srcSeqIndexInterval;
     fillPartnerDeInfo->tensorMixFlag = tensorMixFlag;
@@ -2126,22 +2186,19 @@ template<typename SIT, typename DIT> int sparseMatMulStoreLinSeqVect(
 
   // prepare count arrays for dst partner look-up in srcSeqIndexFactorLookup
   int *dstLocalPartnerElementsPerIntervalCount = new int[petCount];
-  for (int i=0; i<petCount; i++){
-    // Pet "i" is the active dstSeqIndex interval
-    SIT seqIndexMin = srcSeqIndexInterval[i].min;
-    SIT seqIndexMax = srcSeqIndexInterval[i].max;
-    int count = 0; // reset
-    for (typename vector<DD::SeqIndexFactorLookup<DIT> >
-      ::const_iterator j=dstSeqIndexFactorLookup.begin(); 
-      j!=dstSeqIndexFactorLookup.end(); ++j){
-      for (int k=0; k<j->factorCount; k++){
-        DIT partnerSeqIndex = j->factorList[k]
-          .partnerSeqIndex.decompSeqIndex;
-        if (partnerSeqIndex >= seqIndexMin && partnerSeqIndex <= seqIndexMax)
-          ++count; // increment counter
-      }
+  for (int i=0; i<petCount; i++)
+    dstLocalPartnerElementsPerIntervalCount[i] = 0; // reset
+  // single pass over the factors, bisecting into the srcSeqIndex intervals
+  for (typename vector<DD::SeqIndexFactorLookup<DIT> >
+    ::const_iterator j=dstSeqIndexFactorLookup.begin(); 
+    j!=dstSeqIndexFactorLookup.end(); ++j){
+    for (int k=0; k<j->factorCount; k++){
+      DIT partnerSeqIndex = j->factorList[k]
+        .partnerSeqIndex.decompSeqIndex;
+      int i = DD::intervalPet(srcSeqIndexInterval, petCount, partnerSeqIndex);
+      if (i >= 0)
+        ++dstLocalPartnerElementsPerIntervalCount[i]; // increment counter
     }
-    dstLocalPartnerElementsPerIntervalCount[i] = count;
   }
   int *srcLocalPartnerIntervalPerPetCount = new int[petCount];
   vm->alltoall(dstLocalPartnerElementsPerIntervalCount, sizeof(int),
@@ -2157,6 +2214,7 @@ template<typename SIT, typename DIT> int sparseMatMulStoreLinSeqVect(
       new DD::FillPartnerDeInfo<SIT,DIT>
         (srcSeqIndexFactorLookup, dstSeqIndexFactorLookup);
     fillPartnerDeInfo->localPet = localPet;
+    fillPartnerDeInfo->petCount = petCount;
     fillPartnerDeInfo->seqIndexIntervalIn = srcSeqIndexInterval;
     fillPartnerDeInfo->seqIndexIntervalOut = dstSeqIndexInterval;
     fillPartnerDeInfo->tensorMixFlag = tensorMixFlag;
@@ -2259,6 +2317,7 @@ template<typename SIT, typename DIT> int sparseMatMulStoreLinSeqVect(
         (srcLinSeqVect, srcSeqIndexFactorLookup);
     fillLinSeqVectInfo->array = srcArray;
     fillLinSeqVectInfo->localPet = localPet;
+    fillLinSeqVectInfo->petCount = petCount;
     fillLinSeqVectInfo->localDeCount = srcLocalDeCount;
     fillLinSeqVectInfo->localDeElementCount = srcLocalDeElementCount;
     fillLinSeqVectInfo->seqIndexInterval = srcSeqIndexInterval;
@@ -2284,6 +2343,7 @@ template<typename SIT, typename DIT> int sparseMatMulStoreLinSeqVect(
     fillLinSeqVectInfo->array = dstArray;
     fillLinSeqVectInfo->linSeqVect = dstLinSeqVect;
     fillLinSeqVectInfo->localPet = localPet;
+    fillLinSeqVectInfo->petCount = petCount;
     fillLinSeqVectInfo->localDeCount = dstLocalDeCount;
     fillLinSeqVectInfo->localDeElementCount = dstLocalDeElementCount;
     fillLinSeqVectInfo->seqIndexInterval = dstSeqIndexInterval;
@@ -331,6 +331,120 @@ class XXE{
       }
     };
     
+    struct NeighborInfo{
+      // The NeighborInfo holds the state of the neighborhood collective
+      // backend. When present, the non-blocking comm elements of the stream
+      // are not posted individually during exec(). Instead their buffers are
+      // recorded per partner PET, and a single neighborhood all-to-all over
+      // a distributed graph communicator is posted once the last of them is
+      // reached. All of the elements share the resulting request.
+      MPI_Comm comm;                // distributed graph communicator
+      MPI_Request request;          // request of the posted collective
+      int commCount;                // number of nb comm elements in stream
+      int postCount;                // nb comm elements recorded so far
+      std::vector<int> dstIndex;    // PET -> outgoing neighbor index or -1
+      std::vector<int> srcIndex;    // PET -> incoming neighbor index or -1
+      std::vector<std::vector<MPI_Aint> > sendDispl; // per outgoing neighbor
+      std::vector<std::vector<int> > sendLength;     // per outgoing neighbor
+      std::vector<std::vector<MPI_Aint> > recvDispl; // per incoming neighbor
+      std::vector<std::vector<int> > recvLength;     // per incoming neighbor
+      // argument arrays of the posted collective, which must stay valid and
+      // unmodified until the collective completes
+      std::vector<int> sendCounts, recvCounts;
+      std::vector<MPI_Aint> sendDispls, recvDispls;
+      std::vector<MPI_Datatype> sendTypes, recvTypes;
+    };
+    
+    struct AggregateExtent{
+      // Byte extent that depends linearly on the execution time vectorLength.
+      long c;                       // constant part
+      long v;                       // part that scales with vectorLength
+      long at(int vectorL) const {return c + v * (long)vectorL;}
+      bool operator==(AggregateExtent const &other) const{
+        return (c == other.c && v == other.v);
+      }
+    };
+    
+    struct AggregatePiece{
+      // Location of a message inside of a node-local shared memory segment.
+      int owner;                    // SSI-local index of the segment owner
+      AggregateExtent offset;       // offset into the segment
+      AggregateExtent size;         // size of the message
+    };
+    
+    struct AggregateMessage{
+      // Aggregated message exchanged between the leaders of two SSIs.
+      int pet;                      // partner leader PET
+      AggregateExtent offset;       // recv: offset into the local segment
+      AggregateExtent size;         // recv: size of the message
+      std::vector<AggregatePiece> pieces; // send: pieces in message order
+    };
+    
+    struct AggregateInfo{
+      // The AggregateInfo holds the state of the node-aware two-level
+      // aggregation backend. When present, exec() records the non-blocking
+      // comm elements of the stream instead of posting them. Once the last of
+      // them is reached, each PET deposits its outgoing messages into its
+      // SSI-shared segment. Messages between PETs on the same SSI are picked
+      // up directly from there. All messages between a pair of SSIs are
+      // forwarded as a single message between a leader PET on either side,
+      // and scattered from the receiving leader's segment. The exchange
+      // completes before exec() continues, and all of the comm elements point
+      // to the same null request.
+      MPI_Comm comm;                // aggregation communicator of the VM
+      MPI_Request request;          // request shared by all comm elements
+      VMK::memhandle headMemh;      // SSI-shared header handle
+      std::vector<int *> head;      // vectorLength per SSI-local index
+      VMK::memhandle memh;          // SSI-shared segment handle
+      int vectorLengthAlloc;        // vectorLength segments are sized for
+      std::vector<char *> segment;  // segment base per SSI-local index
+      int localIndex;               // SSI-local index of this PET
+      int commCount;                // number of nb comm elements in stream
+      int sendPos;                  // sends recorded so far
+      int recvPos;                  // recvs recorded so far
+      AggregateExtent segmentSize;  // outbox followed by leader inbox
+      std::vector<int> sendPet;     // per send in stream order
+      std::vector<AggregateExtent> sendOffset;  // per send into outbox
+      std::vector<AggregateExtent> sendSize;    // per send
+      std::vector<int> recvPet;     // per recv in stream order
+      std::vector<AggregateExtent> recvSize;    // per recv
+      std::vector<AggregatePiece> recvPiece;    // per recv
+      std::vector<bool> recvIntra;  // per recv: sender on the same SSI
+      std::vector<AggregateMessage> sendMessages; // leader: to other SSIs
+      std::vector<AggregateMessage> recvMessages; // leader: from other SSIs
+      std::vector<char *> sendBuffer;           // recorded during exec()
+      std::vector<int> sendBufferSize;          // recorded during exec()
+      std::vector<char *> recvBuffer;           // recorded during exec()
+      std::vector<int> recvBufferSize;          // recorded during exec()
+    };
+    
+    enum TuneStage{
+      tuneCommOrder, tuneThreadCount, tuneSumVariant, tuneDone
+    };
+    enum SumVariant{
+      sumTestFinish, sumWaitFinish, sumSingle
+    };
+    
+    struct TuneInfo{
+      // The TuneInfo holds the state of the online auto-tuning of exec().
+      // The first blocking exec() calls are timed, while alternative encodings
+      // that only affect the local PET are tried in turn, one stage at a time:
+      // the posting order of the non-blocking comms, the number of threads
+      // used by the super-scalar dst kernels, and, where the caller allows a
+      // free term order, the way received terms are summed. After trialCount
+      // calls per variant the fastest variant of the stage is locked in.
+      int trialCount;               // timed exec() calls per variant
+      TuneStage stage;              // stage currently being tuned
+      int variant;                  // variant under trial within the stage
+      int callCount;                // timed calls of the current variant
+      std::vector<double> bestTime; // per variant of the current stage
+      std::vector<std::vector<int> > commOrderList; // PET priority per variant
+      int commOrder;                // variant applied to the stream, or -1
+      std::vector<int> threadCountList; // thread count per variant
+      int threadCount;              // thread count used by exec()
+      SumVariant sumVariant;        // sum variant for free term order
+    };
+    
   public:
     VM *vm;
     // OPSTREAM
@@ -373,6 +487,11 @@ class XXE{
     int commhandleMaxCount;         // maximum number of elements in commhandle
     int xxeSubMaxCount;             // maximum number of elements in xxeSubList
     RouteHandle *rh;                // associated RouteHandle
+    bool commPersistent;            // use persistent comm requests in exec()
+    NeighborInfo *neighbor;         // neighborhood collective backend or NULL
+    AggregateInfo *aggregate;       // node-aware aggregation backend or NULL
+    TuneInfo *tune;                 // online auto-tuning state or NULL
+    int execThreads;                // threads of super-scalar dst kernels
     
   public:
     XXE(VM *vmArg, int maxArg=1000, int dataMaxCountArg=1000,
@@ -394,6 +513,11 @@ class XXE{
       lastFilterBitField = 0x0;
       superVectorOkay = true;
       rh = NULL;
+      commPersistent = false;
+      neighbor = NULL;
+      aggregate = NULL;
+      tune = NULL;
+      execThreads = 1;
     }
     XXE(std::stringstream &streami,
       std::vector<int> *originToTargetMap=NULL,
@@ -451,9 +575,22 @@ class XXE{
     int print(FILE *fp, int rraCount=0, char **rraList=NULL,
       int filterBitField=0x0, int indexStart=-1, int indexStop=-1);
     int printProfile(FILE *fp);
+    int releaseCollective();
     int execReady();
     int optimize();
     int optimizeElement(int index);
+    int optimizeCommOrder(std::vector<int> const &petPriority);
+    int neighborReady(std::vector<int> const &dstPetList,
+      std::vector<int> const &srcPetList);
+    bool isNeighborEnabled() const {return (neighbor != NULL);}
+    int aggregateReady(std::vector<int> const &dstPetList,
+      std::vector<int> const &srcPetList);
+    bool isAggregateEnabled() const {return (aggregate != NULL);}
+    int tuneReady(int trialCount,
+      std::vector<std::vector<int> > const &commOrderList);
+    bool isTuneEnabled() const {return (tune != NULL);}
+    int tuneBegin(bool sumFree, bool *timed, SumVariant *sumVariant);
+    int tuneEnd(double dTime);
     
     int growStream(int increase);
     int growDataList(int increase);
@@ -1057,6 +1194,22 @@ class XXE{
     }MultiSubInfo;
     
   private:
+    int optimizeCommOrder(std::vector<int> const &petPriority,
+      std::map<XXE *, std::vector<int> > &indexMap);
+    int tuneApply(int variant);
+    int tuneLock();
+    int groupDstTerms(int index);
+    bool neighborEligible(std::vector<int> const &dstPetList,
+      std::vector<int> const &srcPetList, int *commCount);
+    int neighborRecord(bool sendFlag, int pet, void *buffer, int size,
+      VMK::commhandle **commhandle);
+    int neighborPost();
+    int aggregateRecord(bool sendFlag, int pet, char *buffer, int size,
+      VMK::commhandle **commhandle, int vectorL);
+    int aggregatePost(int vectorL);
+    static void termChunkList(int termCount, int vectorL, int threadCount,
+      int *rraOffsetList, int *rraIndexList, int *baseListIndexList,
+      std::vector<int> &chunkList);
     template<typename T>
     inline static void exec_memGatherSrcRRA(
       MemGatherSrcRRAInfo *xxeMemGatherSrcRRAInfo, int vectorL, char **rraList);
@@ -1080,7 +1233,7 @@ class XXE{
     static void pss(T *element, TKId elementTK, U *factor, TKId factorTK,
       V *value, TKId valueTK, int resolved);
     template<typename T, typename V>
-    static void sssDstRra(T *rraBase, TKId elementTK, int *rraOffsetList,
+    void sssDstRra(T *rraBase, TKId elementTK, int *rraOffsetList,
       V *valueBase, int *valueOffsetList, TKId valueTK, int termCount,
       int vectorL, int resolved, int localDeIndexOff,
       int size_r, int size_s, int size_t, int *size_i, int *size_j,
@@ -1094,7 +1247,7 @@ class XXE{
       int localDeIndexOff, int size_r, int size_s, int size_t, int *size_i,
       int *size_j);
     template<typename T, typename V>
-    static void ssslDstRra(T **rraBaseList, int *rraIndexList, TKId elementTK,
+    void ssslDstRra(T **rraBaseList, int *rraIndexList, TKId elementTK,
       int *rraOffsetList, V **valueBaseList,
       int *valueOffsetList, int *baseListIndexList,
       TKId valueTK, int termCount, int vectorL, int resolved,
@@ -1111,7 +1264,7 @@ class XXE{
       int *baseListIndexList, int termCount, int vectorL, int localDeIndexOff,
       int size_r, int size_s, int size_t, int *size_i, int *size_j);
     template<typename T, typename U, typename V>
-    static void psssDstRra(T *rraBase, TKId elementTK, int *rraOffsetList,
+    void psssDstRra(T *rraBase, TKId elementTK, int *rraOffsetList,
       U *factorList, TKId factorTK, V *valueBase, int *valueOffsetList,
       TKId valueTK, int termCount, int vectorL, int resolved,
       int localDeIndexOff,
@@ -1120,13 +1273,23 @@ class XXE{
     template<typename T, typename U, typename V>
     static void exec_psssDstRra(T *rraBase, int *rraOffsetList, U *factorList,
       V *valueBase, int *valueOffsetList, int termCount, int vectorL);
+    static void exec_psssDstRra(ESMC_R8 *rraBase, int *rraOffsetList,
+      ESMC_R8 *factorList, ESMC_R8 *valueBase, int *valueOffsetList,
+      int termCount, int vectorL);
+    static void exec_psssDstRra(ESMC_R4 *rraBase, int *rraOffsetList,
+      ESMC_R8 *factorList, ESMC_R4 *valueBase, int *valueOffsetList,
+      int termCount, int vectorL);
+    template<typename T, typename U, typename V>
+    static void exec_psssDstRraRows(T *rraBase, int *rraOffsetList,
+      U *factorList, V *valueBase, int *valueOffsetList, int termCount,
+      int vectorL);
     template<typename T, typename U, typename V>
     static void exec_psssDstRraSuper(T *rraBase, int *rraOffsetList,
       U *factorList, V *valueBase, int *valueOffsetList, int termCount,
       int vectorL, int localDeIndexOff,
       int size_r, int size_s, int size_t, int *size_i, int *size_j);
     template<typename T, typename U, typename V>
-    static void pssslDstRra(T **rraBaseList, int *rraIndexList, TKId elementTK,
+    void pssslDstRra(T **rraBaseList, int *rraIndexList, TKId elementTK,
       int *rraOffsetList, U *factorList, TKId factorTK, V **valueBaseList,
       int *valueOffsetList, int *baseListIndexList,
       TKId valueTK, int termCount, int vectorL, int resolved, 
@@ -1138,6 +1301,19 @@ class XXE{
       int *rraOffsetList, U *factorList, V **valueBaseList,
       int *valueOffsetList, int *baseListIndexList,
       int termCount, int vectorL);
+    static void exec_pssslDstRra(ESMC_R8 **rraBaseList, int *rraIndexList,
+      int *rraOffsetList, ESMC_R8 *factorList, ESMC_R8 **valueBaseList,
+      int *valueOffsetList, int *baseListIndexList,
+      int termCount, int vectorL);
+    static void exec_pssslDstRra(ESMC_R4 **rraBaseList, int *rraIndexList,
+      int *rraOffsetList, ESMC_R8 *factorList, ESMC_R4 **valueBaseList,
+      int *valueOffsetList, int *baseListIndexList,
+      int termCount, int vectorL);
+    template<typename T, typename U, typename V>
+    static void exec_pssslDstRraRows(T **rraBaseList, int *rraIndexList,
+      int *rraOffsetList, U *factorList, V **valueBaseList,
+      int *valueOffsetList, int *baseListIndexList,
+      int termCount, int vectorL);
     template<typename T, typename U, typename V>
     static void exec_pssslDstRraDynMask(T **rraBaseList, int *rraIndexList, 
       int *rraOffsetList, U *factorList, V **valueBaseList,
@@ -0,0 +1,188 @@
+// $Id$
+//
+// Earth System Modeling Framework
+// Copyright 2002-2020, University Corporation for Atmospheric Research,
+// Massachusetts Institute of Technology, Geophysical Fluid Dynamics
+// Laboratory, University of Michigan, National Centers for Environmental
+// Prediction, Los Alamos National Laboratory, Argonne National Laboratory,
+// NASA Goddard Space Flight Center.
+// Licensed under the University of Illinois-NCSA License.
+
+// ESMCI BVHTree include file for C++
+
+// (all lines below between the !BOP and !EOP markers will be included in
+//  the automated document processing.)
+//-------------------------------------------------------------------------
+// these lines prevent this file from being read more than once if it
+// ends up being included multiple times
+
+#ifndef ESMCI_BVHTree_H
+#define ESMCI_BVHTree_H
+
+// FOR ESMF
+#include <Mesh/include/Legacy/ESMCI_Exception.h>
+
+#include <vector>
+
+//-------------------------------------------------------------------------
+//BOP
+// !CLASS: ESMCI_BVHTree - BVHTree
+//
+// !DESCRIPTION:
+//
+// The code in this file defines the C++ {\tt BVHTree} members and method
+// signatures (prototypes).  The companion file {\tt ESMCI\_BVHTree.C}
+// contains the code (bodies) for building the tree.
+//
+// The {\tt BVHTree} is a bounding volume hierarchy over min-max boxes, with
+// the same add(), commit() and runon() interface as the {\tt OTree}. On
+// commit() the items are sorted along a Morton curve through their box
+// centers, and a binary hierarchy is built over the sorted items, splitting
+// at the highest differing Morton bit. Items and nodes are stored in flat
+// arrays, with the min-max of each coordinate in its own array. The nodes are
+// in depth-first order, each node holding the index of the next node outside
+// of its subtree, so a search is a single forward sweep through the node
+// arrays without a stack. The search takes a templated visitor, so the work
+// done for each hit can be inlined into the sweep.
+//
+// Items can not be added to a committed tree. Use the {\tt OTree} where
+// items need to be inserted between searches.
+//
+//EOP
+//-------------------------------------------------------------------------
+
+
+// Start name space
+namespace ESMCI {
+
+// class definition
+class BVHTree {
+
+ private:
+
+  // items, in Morton order once committed
+  std::vector<double> item_min[3], item_max[3];
+  std::vector<void *> item_data;
+
+  // nodes, in depth-first order
+  std::vector<double> node_min[3], node_max[3];
+  std::vector<int> node_skip;   // index of next node outside of subtree
+  std::vector<int> node_first;  // leaf: index of first item
+  std::vector<int> node_count;  // leaf: number of items, 0 for inner node
+
+  // maximum number of items
+  int max_size_mem;
+
+  // committed
+  bool is_committed;
+
+  // build the subtree over the items [first,last), return root index
+  int build(const std::vector<unsigned int> &code, int first, int last);
+
+  // test of a min-max box against a node or an item box
+  static bool overlap(const double qmin[3], const double qmax[3],
+                      const std::vector<double> *tmin,
+                      const std::vector<double> *tmax, int i) {
+    return (qmax[0] >= tmin[0][i]) && (qmin[0] <= tmax[0][i]) &&
+           (qmax[1] >= tmin[1][i]) && (qmin[1] <= tmax[1][i]) &&
+           (qmax[2] >= tmin[2][i]) && (qmin[2] <= tmax[2][i]);
+  }
+
+  // visitors wrapping the OTree style callbacks
+  struct func_visitor {
+    int (*func)(void *, void *);
+    void *func_data;
+    int operator()(void *data) {return func(data, func_data);}
+  };
+  struct func_visitor_mm_chng {
+    int (*func)(void *, void *, double *, double *);
+    void *func_data;
+    int operator()(void *data, double *min, double *max) {
+      return func(data, func_data, min, max);
+    }
+  };
+
+ public:
+
+  // BVHTree Construct
+  BVHTree(int max_size);
+
+  // BVHTree Destruct
+  ~BVHTree();
+
+  // Add item to tree
+  void add(double min[3], double max[3], void *data);
+
+  // Build tree
+  void commit();
+
+  // Call visit(data) on each item whose min-max box overlaps min-max.
+  // If visit returns anything but 0, then the search stops and runon returns
+  // what visit returned.
+  template <class VISITOR>
+  int runon(const double min[3], const double max[3], VISITOR &visit) const {
+    if (!is_committed)
+      Throw() << "Search tree hasn't been committed, so can't do runon()";
+    const int num_nodes = node_skip.size();
+    int i = 0;
+    while (i < num_nodes) {
+      if (overlap(min, max, node_min, node_max, i)) {
+        const int end = node_first[i] + node_count[i];
+        for (int j = node_first[i]; j < end; j++) {
+          if (overlap(min, max, item_min, item_max, j)) {
+            int rc = visit(item_data[j]);
+            if (rc) return rc;
+          }
+        }
+        ++i;
+      } else i = node_skip[i];
+    }
+    return 0;
+  }
+
+  // Same as runon(), but the search box may be changed by visit(data,min,max)
+  // as the search progresses. The initial search box is init_min-init_max.
+  template <class VISITOR>
+  int runon_mm_chng(const double init_min[3], const double init_max[3],
+                    VISITOR &visit) const {
+    if (!is_committed)
+      Throw() << "Search tree hasn't been committed, so can't do runon()";
+    double min[3] = {init_min[0], init_min[1], init_min[2]};
+    double max[3] = {init_max[0], init_max[1], init_max[2]};
+    const int num_nodes = node_skip.size();
+    int i = 0;
+    while (i < num_nodes) {
+      if (overlap(min, max, node_min, node_max, i)) {
+        const int end = node_first[i] + node_count[i];
+        for (int j = node_first[i]; j < end; j++) {
+          if (overlap(min, max, item_min, item_max, j)) {
+            int rc = visit(item_data[j], min, max);
+            if (rc) return rc;
+          }
+        }
+        ++i;
+      } else i = node_skip[i];
+    }
+    return 0;
+  }
+
+  // OTree compatible searches through a callback
+  int runon(double min[3], double max[3], int (*func)(void *,void *),
+            void *func_data) {
+    func_visitor visit = {func, func_data};
+    return runon(min, max, visit);
+  }
+
+  int runon_mm_chng(double init_min[3], double init_max[3],
+                    int (*func)(void *, void *, double *, double *),
+                    void *func_data) {
+    func_visitor_mm_chng visit = {func, func_data};
+    return runon_mm_chng(init_min, init_max, visit);
+  }
+
+};  // end class BVHTree
+
+
+} // END ESMCI namespace
+
+#endif  // ESMCI_BVHTree_H
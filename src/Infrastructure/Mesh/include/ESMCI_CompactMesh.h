@@ -0,0 +1,123 @@
+// $Id$
+//
+// Earth System Modeling Framework
+// Copyright 2002-2020, University Corporation for Atmospheric Research,
+// Massachusetts Institute of Technology, Geophysical Fluid Dynamics
+// Laboratory, University of Michigan, National Centers for Environmental
+// Prediction, Los Alamos National Laboratory, Argonne National Laboratory,
+// NASA Goddard Space Flight Center.
+// Licensed under the University of Illinois-NCSA License.
+
+// ESMCI CompactMesh include file for C++
+
+// (all lines below between the !BOP and !EOP markers will be included in
+//  the automated document processing.)
+//-------------------------------------------------------------------------
+// these lines prevent this file from being read more than once if it
+// ends up being included multiple times
+
+#ifndef ESMCI_CompactMesh_H
+#define ESMCI_CompactMesh_H
+
+// FOR ESMF
+#include <Mesh/include/Legacy/ESMCI_Exception.h>
+
+#include <vector>
+
+//-------------------------------------------------------------------------
+//BOP
+// !CLASS: ESMCI_CompactMesh - CompactMesh
+//
+// !DESCRIPTION:
+//
+// The code in this file defines the C++ {\tt CompactMesh} members and
+// method signatures (prototypes).  The companion file
+// {\tt ESMCI\_CompactMesh.C} contains the code (bodies) for the methods
+// of the class.
+//
+// The {\tt CompactMesh} holds the cells of a logically rectangular Grid
+// in flat arrays instead of the objects of the {\tt Mesh}. The nodes
+// are the corners of the cells, with their global id, owning PET and
+// Cartesian coordinates in one array each. The cells refer to their
+// nodes by local index in compressed row form, so a cell $e$ has the
+// nodes {\tt elem\_conn[elem\_conn\_beg[e],elem\_conn\_beg[e+1])}, and
+// their mask values and user areas are again in arrays of their own.
+// This takes a few tens of bytes per node, instead of the hundreds that
+// a node of the {\tt Mesh} takes with its relations and map entries.
+//
+// Only the locally owned cells are held, together with all the nodes
+// they need, so the nodes owned by other PETs come with coordinates and
+// don't have to be haloed later. Each cell also keeps the localDE and
+// index it came from in the center stagger of the Grid, so results
+// computed on the cells can go straight back into Arrays on the Grid.
+//
+//EOP
+//-------------------------------------------------------------------------
+
+
+// Start name space
+namespace ESMCI {
+
+// class definition
+class CompactMesh {
+
+ public:
+
+  // parametric and spatial dimension
+  int pdim;
+  int sdim;
+
+  // nodes
+  std::vector<int> node_gid;
+  std::vector<int> node_owner;
+  std::vector<double> node_coords;   // sdim per node
+
+  // elements, with their nodes in compressed row form
+  std::vector<int> elem_gid;
+  std::vector<int> elem_conn_beg;    // num_elems()+1 of them
+  std::vector<int> elem_conn;        // local node index
+  std::vector<int> elem_de;          // localDE of the center stagger
+  std::vector<int> elem_index;       // pdim index of the center stagger
+
+  // element mask values and user areas, empty if the Grid has none
+  std::vector<double> elem_mask_val;
+  std::vector<double> elem_area;
+
+  // CompactMesh Construct
+  CompactMesh(int pdim, int sdim);
+
+  // CompactMesh Destruct
+  ~CompactMesh();
+
+  int num_nodes() const {return node_gid.size();}
+
+  int num_elems() const {return elem_gid.size();}
+
+  // Add a node without coordinates, return its local index
+  int add_node(int gid, int owner);
+
+  // Add an element over the num local nodes in nodes, return its index
+  int add_elem(int gid, int num, const int *nodes, int de, const int *index);
+
+  // Number of nodes of an element
+  int elem_num_nodes(int e) const {
+    return elem_conn_beg[e+1]-elem_conn_beg[e];
+  }
+
+  // Get the coordinates of an element counter clockwise, without
+  // degenerate edges. Returns the number of nodes left.
+  int get_elem_coords_ccw(int e, double *tmp_coords, double *coords) const;
+
+  // Calculate the area of every element, from the coordinates of its
+  // nodes. The user area is not used here.
+  void calc_elem_areas(std::vector<double> &areas) const;
+
+  // Bytes used by the arrays
+  size_t memory_bytes() const;
+
+};  // end class CompactMesh
+
+
+} // END ESMCI namespace
+
+#endif  // ESMCI_CompactMesh_H
@@ -0,0 +1,145 @@
+// $Id$
+//
+// Earth System Modeling Framework
+// Copyright 2002-2020, University Corporation for Atmospheric Research,
+// Massachusetts Institute of Technology, Geophysical Fluid Dynamics
+// Laboratory, University of Michigan, National Centers for Environmental
+// Prediction, Los Alamos National Laboratory, Argonne National Laboratory,
+// NASA Goddard Space Flight Center.
+// Licensed under the University of Illinois-NCSA License.
+
+// ESMCI KDTree include file for C++
+
+// (all lines below between the !BOP and !EOP markers will be included in
+//  the automated document processing.)
+//-------------------------------------------------------------------------
+// these lines prevent this file from being read more than once if it
+// ends up being included multiple times
+
+#ifndef ESMCI_KDTree_H
+#define ESMCI_KDTree_H
+
+// FOR ESMF
+#include <Mesh/include/Legacy/ESMCI_Exception.h>
+
+#include <vector>
+
+//-------------------------------------------------------------------------
+//BOP
+// !CLASS: ESMCI_KDTree - KDTree
+//
+// !DESCRIPTION:
+//
+// The code in this file defines the C++ {\tt KDTree} members and method
+// signatures (prototypes).  The companion file {\tt ESMCI\_KDTree.C}
+// contains the code (bodies) for building and searching the tree.
+//
+// The {\tt KDTree} finds the nearest N points to a query point. The tree is
+// bulk loaded on commit() by recursively splitting the points at the median
+// of the coordinate with the largest extent, down to leaf buckets of a few
+// points. The points of a leaf are contiguous in per coordinate arrays, and
+// the nodes are in depth-first order with the bounding box of their points,
+// so a search mostly runs through contiguous memory. A search descends into
+// the nearer child first and keeps the best points found so far in a bounded
+// max-heap, pruning the nodes whose box is further away than the worst of
+// them once the heap is full.
+//
+// The points found are the N smallest by distance and then by id, which
+// makes the result independent of the order the points were added in. The
+// search of many query points at once is spread over the threads of the PET.
+//
+//EOP
+//-------------------------------------------------------------------------
+
+
+// Start name space
+namespace ESMCI {
+
+// point found by a search
+struct KDTreeHit {
+  double dist2;  // squared distance to the query point
+  int id;
+  void *data;
+
+  bool operator<(const KDTreeHit &rhs) const {
+    if (dist2 != rhs.dist2) return dist2 < rhs.dist2;
+    return id < rhs.id;
+  }
+};
+
+// class definition
+class KDTree {
+
+ private:
+
+  // points, by leaf once committed
+  std::vector<double> pnt_crd[3];
+  std::vector<int> pnt_id;
+  std::vector<void *> pnt_data;
+
+  // nodes, in depth-first order, so the left child follows its parent
+  std::vector<double> node_min[3], node_max[3];
+  std::vector<int> node_first;  // index of first point
+  std::vector<int> node_end;    // index after last point
+  std::vector<int> node_right;  // right child, -1 for a leaf
+
+  // maximum number of points
+  int max_size_mem;
+
+  // committed
+  bool is_committed;
+
+  // build the subtree over the points perm[first,last), return root index
+  int build(std::vector<int> &perm, int first, int last);
+
+  // search for the nearest points, doesn't throw so it can run in threads
+  int search(const double pnt[3], int n, double max_dist2,
+             KDTreeHit *hits) const;
+
+  // squared distance from pnt to the box of a node
+  double box_dist2(int node, const double pnt[3]) const {
+    double dist2=0.0;
+    for (int d=0; d<3; d++) {
+      double dd=0.0;
+      if (pnt[d] < node_min[d][node]) dd=node_min[d][node]-pnt[d];
+      else if (pnt[d] > node_max[d][node]) dd=pnt[d]-node_max[d][node];
+      dist2 += dd*dd;
+    }
+    return dist2;
+  }
+
+ public:
+
+  // KDTree Construct
+  KDTree(int max_size);
+
+  // KDTree Destruct
+  ~KDTree();
+
+  // Add point to tree
+  void add(const double pnt[3], int id, void *data);
+
+  // Build tree
+  void commit();
+
+  // Number of points in the tree
+  int size() const {return pnt_id.size();}
+
+  // Find the n nearest points to pnt which are at most sqrt(max_dist2)
+  // away. They are put into hits ordered by distance and then id. Returns
+  // the number of points found.
+  int nearest_n(const double pnt[3], int n, double max_dist2,
+                KDTreeHit *hits) const;
+
+  // Do the above for num points, given as x,y,z in pnts. The maximum
+  // squared distance of each point is in max_dist2, or unlimited if NULL.
+  // The hits of point i are in hits[i*n,i*n+num_hits[i]).
+  void nearest_n(int num, const double *pnts, const double *max_dist2,
+                 int n, int *num_hits, KDTreeHit *hits) const;
+
+};  // end class KDTree
+
+
+} // END ESMCI namespace
+
+#endif  // ESMCI_KDTree_H
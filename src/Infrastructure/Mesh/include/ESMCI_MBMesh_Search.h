@@ -15,7 +15,7 @@
 // Take out if MOAB isn't being used
 #if defined ESMF_MOAB
 
-#include <Mesh/include/ESMCI_OTree.h>
+#include <Mesh/include/ESMCI_BVHTree.h>
 #include <Mesh/include/Regridding/ESMCI_SearchFlags.h>
 #include <Mesh/include/ESMCI_MBMesh.h>
 
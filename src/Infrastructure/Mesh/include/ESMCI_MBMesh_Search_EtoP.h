@@ -67,7 +67,7 @@ void MBMesh_Search_EToP(MBMesh *mbmAp,
                         int *map_type, double stol, 
                         MBMesh_Search_EToP_Result_List &result,
                         bool set_dst_status, WMat &dst_status,
-                        std::vector<int> *revised_dst_loc, OTree *box_in);
+                        std::vector<int> *revised_dst_loc, BVHTree *box_in);
 
 #endif
 #endif
@@ -43,6 +43,35 @@ namespace ESMCI {
 
   double tri_area(const double * const u, const double * const v, const double * const w);
 
+  // Great circle areas of num triangles at once. The corners are given in
+  // SoA layout, i.e. u[d][i] is coordinate d of the first corner of triangle i.
+  void tri_area_soa(int num, const double * const u[3], const double * const v[3],
+                    const double * const w[3], double *area);
+
+  // Batch of polygons whose great circle areas are computed together. The
+  // areas are the same as from great_circle_area(), but the triangles of all
+  // the polygons in the batch are processed in one vector loop.
+  class GCAreaBatch {
+  public:
+    // Add polygon of n points (x,y,z), return its index in the batch
+    int add(int n, const double *pnts);
+
+    // Compute the areas of the polygons added since the last clear()
+    void calc();
+
+    double area(int i) const {return poly_area[i];}
+
+    int size() const {return poly_area.size();}
+
+    void clear();
+
+  private:
+    std::vector<int> poly_tri_beg;      // first triangle of each polygon
+    std::vector<double> corner[3][3];   // [corner][coord] of each triangle
+    std::vector<double> tri_area;
+    std::vector<double> poly_area;
+  };
+
   void get_elem_coords(const MeshObj *elem, const MEField<>  *cfield, int sdim, int max_num_nodes, int *num_nodes, double *coords);
 
   void get_elem_coords_2D_ccw(const MeshObj *elem, MEField<>  *cfield, int max_num_nodes,double *tmp_coords,
@@ -252,6 +252,8 @@ namespace ESMCI {
                                MeshCap **meshpp, ESMCI::Array **arraypp, int *staggerLoc,
                                int *regridScheme, int*rc);
 
+    static void regrid_getarea_grid(Grid **gridpp, ESMCI::Array **arraypp, int*rc);
+
 
     static void regrid_getfrac(Grid **gridpp,
                                MeshCap **meshpp, ESMCI::Array **arraypp, int *staggerLoc,
@@ -23,6 +23,7 @@
 #include "ESMCI_Grid.h"
 #include "ESMCI_Ptypes.h"
 #include "Mesh/include/ESMCI_Mesh.h"
+#include "Mesh/include/ESMCI_CompactMesh.h"
 #include "Mesh/include/Regridding/ESMCI_MeshRegrid.h"
 #include "Mesh/include/Legacy/ESMCI_IOField.h"
 #include "Mesh/include/Legacy/ESMCI_ParEnv.h"
@@ -52,6 +53,10 @@ namespace ESMCI {
 
   void PutElemAreaIntoArrayCell(Grid *grid, ESMCI::Mesh *mesh, ESMCI::Array *array);
 
+  void ESMCI_GridToCompactMesh(const Grid &grid_, CompactMesh **out_cmeshpp, int *rc);
+
+  void PutElemAreaIntoArrayCompact(Grid *grid, CompactMesh *cmesh, ESMCI::Array *array);
+
 #if 0
   void ESMCI_GridToMesh(const Grid &grid_, int staggerLoc, ESMCI::Mesh &mesh, 
                         const std::vector<ESMCI::Array*> &arrays, ESMCI::InterArray<int> *maskValuesArg,
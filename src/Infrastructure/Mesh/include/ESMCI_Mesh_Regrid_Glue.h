@@ -36,6 +36,7 @@
 #include "Mesh/include/Regridding/ESMCI_ExtrapolationPoleLGC.h"
 #include "Mesh/include/ESMCI_MathUtil.h"
 #include "Mesh/include/Regridding/ESMCI_Regrid_Helper.h"
+#include "Mesh/include/Regridding/ESMCI_RegridMaskUpdate.h"
 #include "ESMCI_PointList.h"
 
 //-----------------------------------------------------------------------------
@@ -76,6 +77,25 @@ void ESMCI_regrid_getarea(Grid **gridpp,
                    Mesh **meshpp, ESMCI::Array **arraypp, int *staggerLoc,
                           int *regridScheme, int*rc);
 
+// Area of the cells of a 2D Grid, without building a Mesh first
+void ESMCI_regrid_getarea_grid(Grid **gridpp, ESMCI::Array **arraypp, int*rc);
+
+// Incremental regrid store for changing masks, see ESMCI_RegridMaskUpdate.h
+void ESMCI_regrid_mask_update_create(int *regridMethod, int *norm_type,
+                         int *num_entries, int *iientries, double *factors,
+                         ESMCI::RegridMaskUpdate **mup, int *rc);
+
+void ESMCI_regrid_mask_update(ESMCI::RegridMaskUpdate **mup,
+                         ESMCI::Array **arraysrcpp, ESMCI::Array **arraydstpp,
+                         int *num_src, int *src_seq, int *src_mask,
+                         int *num_dst, int *dst_seq, int *dst_mask,
+                         int *unmappedaction,
+                         int *srcTermProcessing, int *pipelineDepth,
+                         ESMCI::RouteHandle **rh, int *rc);
+
+void ESMCI_regrid_mask_update_destroy(ESMCI::RegridMaskUpdate **mup,
+                         int *rc);
+
 void ESMCI_regrid_getfrac(Grid **gridpp,
                    Mesh **meshpp, ESMCI::Array **arraypp, int *staggerLoc,
                      int *rc);
@@ -0,0 +1,135 @@
+// $Id$
+//
+// Earth System Modeling Framework
+// Copyright 2002-2020, University Corporation for Atmospheric Research,
+// Massachusetts Institute of Technology, Geophysical Fluid Dynamics
+// Laboratory, University of Michigan, National Centers for Environmental
+// Prediction, Los Alamos National Laboratory, Argonne National Laboratory,
+// NASA Goddard Space Flight Center.
+// Licensed under the University of Illinois-NCSA License.
+
+// ESMCI SFCPartition include file for C++
+
+// (all lines below between the !BOP and !EOP markers will be included in
+//  the automated document processing.)
+//-------------------------------------------------------------------------
+// these lines prevent this file from being read more than once if it
+// ends up being included multiple times
+
+#ifndef ESMCI_SFCPartition_H
+#define ESMCI_SFCPartition_H
+
+// FOR ESMF
+#include <Mesh/include/Legacy/ESMCI_Exception.h>
+
+#include <mpi.h>
+
+#include <vector>
+
+//-------------------------------------------------------------------------
+//BOP
+// !CLASS: ESMCI_SFCPartition - SFCPartition
+//
+// !DESCRIPTION:
+//
+// The code in this file defines the C++ {\tt SFCPartition} members and
+// method signatures (prototypes).  The companion file
+// {\tt ESMCI\_SFCPartition.C} contains the code (bodies) for building and
+// querying the partition.
+//
+// The {\tt SFCPartition} splits space between the PETs of a communicator
+// along a Hilbert curve, as a replacement of the recursive coordinate
+// bisection of Zoltan for the geometric rendezvous. Points are put on a
+// grid of $2^b$ cells per dimension over a box, and each cell gets the
+// Hilbert index of its position on the curve. The index range of the curve
+// is cut into one contiguous piece per PET, so that each PET gets the same
+// number of points. The cuts are found by bisection of the index, counting
+// the points below each candidate cut over all PETs, which makes them
+// depend only on the points and not on how they are spread over the PETs.
+//
+// Every cell of the grid, and every cell of the coarser grids on the way
+// down, is a contiguous range of the index. So the PETs whose piece touches
+// a box are found by descending into the cells that overlap the box until
+// a cell lies within the piece of one PET. As the pieces cover all of
+// space, objects sent to the PETs touching their box meet the points and
+// objects they overlap on at least one PET. Points outside the box of the
+// partition are moved onto its boundary cells, so a partition stays valid
+// for other sets of points in the same region of space.
+//
+// On the sphere the points are 3D Cartesian coordinates, and the curve runs
+// through the cube around them, with the cut pieces following the surface.
+//
+//EOP
+//-------------------------------------------------------------------------
+
+
+// Start name space
+namespace ESMCI {
+
+// class definition
+class SFCPartition {
+
+ public:
+
+  typedef unsigned long long Key;
+
+ private:
+
+  // spatial dimension, 2 or 3
+  int sdim;
+
+  // bits of grid position per dimension
+  int bits;
+
+  // grid over the box
+  double origin[3];
+  double scale[3];
+
+  // first key of each PET but the first, nproc-1 of them
+  std::vector<Key> cuts;
+
+  // grid position of a coordinate, clamped to the grid
+  unsigned int grid_pos(int d, double x) const;
+
+  // Hilbert index of a grid position
+  Key hilbert_key(const unsigned int pos[]) const;
+
+  // PET owning a key
+  int owner(Key key) const;
+
+  // descend into the cells overlapping [lo,hi], adding the PETs to procs
+  void box_cell(int level, const unsigned int cell[],
+                const unsigned int lo[], const unsigned int hi[],
+                std::vector<int> &procs) const;
+
+ public:
+
+  // SFCPartition Construct, over the box [cmin,cmax] of dimension sdim
+  SFCPartition(int sdim, const double cmin[], const double cmax[]);
+
+  // SFCPartition Destruct
+  ~SFCPartition();
+
+  // Cut the curve into balanced pieces for the num points in pnts, given
+  // with sdim coordinates each. Collective over comm.
+  void partition(int num, const double *pnts, MPI_Comm comm);
+
+  // Number of PETs the partition was made for
+  int num_procs() const {return cuts.size()+1;}
+
+  // Hilbert index of a point
+  Key key(const double pnt[]) const;
+
+  // PET owning a point
+  int point_owner(const double pnt[]) const {return owner(key(pnt));}
+
+  // PETs whose piece touches the box [bmin,bmax], in ascending order
+  void box_owners(const double bmin[], const double bmax[],
+                  std::vector<int> &procs) const;
+
+};  // end class SFCPartition
+
+
+} // END ESMCI namespace
+
+#endif  // ESMCI_SFCPartition_H
@@ -14,7 +14,7 @@
 
 #include <list>
 
-#include <Mesh/include/ESMCI_OTree.h>
+#include <Mesh/include/ESMCI_BVHTree.h>
 #include <Mesh/include/Regridding/ESMCI_Mapping.h>
 #include <Mesh/include/Regridding/ESMCI_SearchFlags.h>
 #include <Mesh/include/Regridding/ESMCI_WMat.h>
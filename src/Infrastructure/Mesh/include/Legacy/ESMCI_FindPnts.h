@@ -19,7 +19,7 @@
 #include <Mesh/include/Legacy/ESMCI_MeshObj.h>
 #include <Mesh/include/ESMCI_Mesh.h>
 #include <Mesh/include/Legacy/ESMCI_MeshUtils.h>
-#include <Mesh/include/ESMCI_OTree.h>
+#include <Mesh/include/ESMCI_BVHTree.h>
 #include <Mesh/include/Regridding/ESMCI_SearchFlags.h>
 #include <Mesh/include/Legacy/ESMCI_Exception.h> 
 #include <algorithm>
@@ -24,6 +24,7 @@ namespace ESMCI {
 
 class BBox;
 class _field;
+class SFCPartition;
         
 class GeomRend {
 public:
@@ -118,6 +119,14 @@ private:
   // Zoltan parameters
   void set_zolt_param(Zoltan_Struct *zz);
 
+  // Partition along a space filling curve instead of with Zoltan, returning
+  // the objects that move in the layout of the Zoltan lists
+  void sfc_partition(ZoltanUD &zud, const BBox &dstBound,
+                     std::vector<ZOLTAN_ID_TYPE> &exportGids,
+                     std::vector<ZOLTAN_ID_TYPE> &exportLids,
+                     std::vector<int> &exportProcs,
+                     std::vector<ZOLTAN_ID_TYPE> &importGids);
+
   void build_src_mig(Zoltan_Struct *zz, ZoltanUD &zud);
 
   void build_dst_mig_all_overlap(ZoltanUD &zud);
@@ -168,6 +177,9 @@ private:
   // Treat as on a spherical surface (probably because we're using great circle edges)
   bool on_sph;
 
+  // Space filling curve partition used instead of the Zoltan RCB cuts, if not NULL
+  const SFCPartition *sfc_part;
+
   /*
    * Store the fields on the rendezvous meshes that line up with those
    * sent into Build.  Depending on the type of transfer, the destination
@@ -24,7 +24,9 @@ class IWeights;
 /*
  * Gather the weights to a row-order and distributed decomposition
  * so that each processor will output a chunk of the netcdf file.
- * The user MUST call this prior to writing the weights.
+ * This is only needed if the entries in the file should be sorted by
+ * row, the writers below write the local entries of each processor
+ * wherever they are.
  */
 void GatherForWrite(IWeights &w);
 
@@ -47,6 +49,23 @@ void WriteNCMatFilePar(const std::string &src_ncfile,
                     int ordering = NCMATPAR_ORDER_INTERLEAVE
                     );
 
+/*
+ * Write only the matrix (n_s, col, row, S), in parallel.  Each processor
+ * finds the offset of its entries with a prefix sum and writes them as
+ * one slab with collective I/O, so there is no migration of the weights.
+ * n_a and n_b are used to number the idx > 0 entries as above.
+ * If deflate_level > 0 the file is written as netCDF-4 with chunked and
+ * compressed variables, which needs a netCDF built with parallel I/O
+ * support for filters.  Otherwise PnetCDF is used.
+ */
+void WriteNCMatWeightsPar(const std::string &outfile,
+                    const IWeights &w,
+                    int n_a,
+                    int n_b,
+                    int ordering = NCMATPAR_ORDER_SEQ,
+                    int deflate_level = 0
+                    );
+
 } // namespace
 
 #endif /*ESMC_WRITEWEIGHTSPAR_H_*/
@@ -18,6 +18,7 @@
 #include <Mesh/include/Legacy/ESMCI_Migrator.h>
 #include <Mesh/include/Legacy/ESMCI_SparseMsg.h>
 #include <Mesh/include/Regridding/ESMCI_WMat.h>
+#include <Mesh/include/Regridding/ESMCI_WMatCSR.h>
 #include <Mesh/include/Regridding/ESMCI_Mapping.h>
 #include <Mesh/src/Zoltan/zoltan.h>
 #include "PointList/include/ESMCI_PointList.h"
@@ -74,6 +75,13 @@ public:
    */
   void Prune(const Mesh &mesh, const MEField<> *mask=0);
 
+
+  /*
+   * Compact weights filled by the conservative methods. These are kept
+   * here instead of in the WMat rows, since the conservative matrices are
+   * too large to hold efficiently in the map.
+   */
+  WMatCSR csr;
 };
 
 // Tangent vector support
@@ -21,9 +21,52 @@
 #include <Mesh/include/Legacy/ESMCI_MCoord.h>
 
 #include <map>
+#include <utility>
+#include <vector>
 
 namespace ESMCI {
 
+// Least squares solver for the small dense systems of the patches. It
+// keeps its workspace between solves, so one solver should be used for
+// all the patches of a transfer. The systems are solved here by a QR
+// factorization with column pivoting, followed by an SVD of R when it
+// is badly conditioned, so the small singular values are truncated as
+// LAPACK dgelsd does. Only the systems this can't decide go to dgelsd.
+class PatchLSQ {
+public:
+PatchLSQ();
+
+// Pseudo-inverse of the m x n matrix mat (column major) into pinv, as
+// pinv[j*ldp+i] for row i and column j. Returns false without touching
+// mat if the system is underdetermined, or if a singular value is too
+// close to the truncation limit of dgelsd to be sure which way it goes.
+bool qr_pinv(int m, int n, const double *mat, int ldp, double *pinv);
+
+// Solve with dgelsd, overwriting mat and rhs (ldb x nrhs)
+void dgelsd(int m, int n, int nrhs, double *mat, double *rhs, int ldb);
+
+// Buffer of at least size entries for a pseudo-inverse
+double *pinv_buf(int size) {
+  if (pbuf.size() < (size_t) size) pbuf.resize(size);
+  return &pbuf[0];
+}
+
+private:
+// pseudo-inverse of R into rinv from its SVD, false if undecided
+bool svd_pinv_r(int m, int n);
+
+// QR and SVD workspace
+std::vector<double> qr, tau, rinv, q1, pbuf;
+std::vector<double> svd_w, svd_v, svd_s;
+std::vector<int> perm;
+
+// LAPACK workspace, with the work size of each (m,n),nrhs
+typedef std::pair<std::pair<int,int>,int> LWorkKey;
+std::vector<double> s, work;
+std::vector<int> iwork;
+std::map<LWorkKey, int> lwork_map;
+};
+
 template <typename NFIELD=MEField<>, typename Real=double>
 class PatchRecov {
 public:
@@ -55,7 +98,8 @@ void CreatePatch(UInt pdeg,
                                  // patch becomes invalid, we reduce it to a first order patch.
            const MEField<> &coord, // node coords (if pdim<sdim, then the object can
                  const MCoord *_mc = NULL,
-           MEField<> *src_mask_ptr=NULL
+           MEField<> *src_mask_ptr=NULL,
+           PatchLSQ *lsq=NULL    // solver to use, if NULL a new one
            );
 
 // field = linearized field index
@@ -104,7 +148,8 @@ void CreateElemPatch(UInt pdeg,
            UInt numfields,
            NFIELD **rfield,
            UInt threshold,       // How far from num dofs to invalidate.  If the
-           bool boundary_ok = false // if true, forms the patch with boundary nodes that have >= 2 elems
+           bool boundary_ok = false, // if true, forms the patch with boundary nodes that have >= 2 elems
+           PatchLSQ *lsq = NULL     // solver for the patches, if NULL a new one
            );
 
 /**
@@ -0,0 +1,95 @@
+// $Id$
+// Earth System Modeling Framework
+// Copyright 2002-2020, University Corporation for Atmospheric Research,
+// Massachusetts Institute of Technology, Geophysical Fluid Dynamics
+// Laboratory, University of Michigan, National Centers for Environmental
+// Prediction, Los Alamos National Laboratory, Argonne National Laboratory,
+// NASA Goddard Space Flight Center.
+// Licensed under the University of Illinois-NCSA License.
+
+//
+//-----------------------------------------------------------------------------
+#ifndef ESMCI_RegridMaskUpdate_h
+#define ESMCI_RegridMaskUpdate_h
+
+#include <vector>
+
+namespace ESMCI {
+
+/**
+ * Derive the regrid weights for changing source and destination masks
+ * from the weights computed without masks, so that only the weight
+ * rows touched by a mask change have to be recomputed instead of
+ * redoing the whole regrid store.
+ *
+ * This is exact for first order conservative regridding. Masking a
+ * source cell there only removes its column, masking a destination cell
+ * removes its row, and the destination fraction used by the fracarea
+ * normalization is the sum of the unmasked destination area weights in
+ * the row. The other methods select different source points when masks
+ * change, and are not supported.
+ *
+ * The entries are held by destination row in the layout of the factor
+ * index list (src, dst sequence index pairs), as they come out of the
+ * regrid store on this PET.
+ */
+class RegridMaskUpdate {
+
+public:
+
+  // Is the regrid method supported
+  static bool supported(int regridMethod);
+
+  // factors must be the unmasked weights with the dstarea normalization
+  RegridMaskUpdate(int regridMethod, int normType, int num_entries,
+                   const int *iientries, const double *factors);
+
+  ~RegridMaskUpdate();
+
+  /*
+   * Change the masks of cells, 1 masks a cell, 0 unmasks it. Each PET
+   * passes the changes of its own cells, the changes are exchanged so
+   * that all weight rows referring to them are found. Must be called
+   * on all PETs. Returns the number of local rows that were recomputed.
+   */
+  int update(int num_src, const int *src_seq, const int *src_mask,
+             int num_dst, const int *dst_seq, const int *dst_mask);
+
+  // The weights for the current masks, without the masked entries
+  void get_factors(std::vector<int> &iientries,
+                   std::vector<double> &factors) const;
+
+  // Destination cells that are not masked, but lost all of their weights
+  void get_unmapped(std::vector<int> &dst_seq) const;
+
+  int num_rows() const { return row_dst.size(); }
+
+private:
+
+  // Recompute the current weights of row r
+  void calc_row(int r);
+
+  int normType;
+
+  // rows, the destination sequence index of each and its entries
+  std::vector<int> row_dst;
+  std::vector<int> row_ptr;
+  std::vector<char> row_masked;
+
+  // entries, by row
+  std::vector<int> ent_src;
+  std::vector<int> ent_col;
+  std::vector<double> ent_wgt;  // unmasked dstarea weight
+  std::vector<double> ent_cur;  // weight for the current masks
+
+  // columns, the source sequence index of each and the rows using it
+  std::vector<int> col_src;
+  std::vector<int> col_ptr;
+  std::vector<int> col_row;
+  std::vector<char> col_masked;
+
+};
+
+} // namespace
+
+#endif
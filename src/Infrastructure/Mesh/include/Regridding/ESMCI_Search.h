@@ -14,7 +14,7 @@
 
 #include <list>
 
-#include <Mesh/include/ESMCI_OTree.h>
+#include <Mesh/include/ESMCI_BVHTree.h>
 #include <Mesh/include/Legacy/ESMCI_MeshTypes.h>
 #include <Mesh/include/Legacy/ESMCI_MeshObj.h>
 #include <Mesh/include/Regridding/ESMCI_Mapping.h>
@@ -20,7 +20,7 @@
 #define ESMCI_SpaceDir_H
 
 #include <Mesh/include/Legacy/ESMCI_Exception.h>
-#include <Mesh/include/ESMCI_OTree.h>
+#include <Mesh/include/ESMCI_BVHTree.h>
 #include <vector>
 #include <set>
 //-------------------------------------------------------------------------
@@ -54,8 +54,8 @@ class SpaceDir {    // inherits from ESMC_Base class
 
  private:
  
-  // Serial OTree holding fine scale min max boxes for objects on local proc
-  OTree *otree;
+  // Serial BVHTree holding fine scale min max boxes for objects on local proc
+  BVHTree *otree;
 
   // min max box of local proc
   double proc_min[3];
@@ -65,14 +65,14 @@ class SpaceDir {    // inherits from ESMC_Base class
   int *proc_nums;
 
   // otree holding proc min max boxes
-  OTree *proc_otree;
+  BVHTree *proc_otree;
 
  public:
 
   // SpaceDir Construct 
-  SpaceDir(double proc_min[3], double proc_max[3], OTree *otree, bool searchThisProc=true);
+  SpaceDir(double proc_min[3], double proc_max[3], BVHTree *otree, bool searchThisProc=true);
 
-  // SpaceDir Destruct (Does not delete OTree)
+  // SpaceDir Destruct (Does not delete BVHTree)
   ~SpaceDir();
 
   // Get list of procs that might hold min-max box
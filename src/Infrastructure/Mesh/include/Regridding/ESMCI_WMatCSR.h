@@ -0,0 +1,207 @@
+// $Id$
+// Earth System Modeling Framework
+// Copyright 2002-2020, University Corporation for Atmospheric Research,
+// Massachusetts Institute of Technology, Geophysical Fluid Dynamics
+// Laboratory, University of Michigan, National Centers for Environmental
+// Prediction, Los Alamos National Laboratory, Argonne National Laboratory,
+// NASA Goddard Space Flight Center.
+// Licensed under the University of Illinois-NCSA License.
+
+//
+//-----------------------------------------------------------------------------
+#ifndef ESMCI_WMatCSR_h
+#define ESMCI_WMatCSR_h
+
+#include <Mesh/include/Regridding/ESMCI_WMat.h>
+
+#include <vector>
+
+namespace ESMCI {
+
+class Mesh;
+class _field;
+
+template<class> class MEField;
+
+/**
+ * A compact weight matrix in compressed sparse row form. Rows and
+ * columns are keyed by the same (id, idx, src_id) triple as the WMat
+ * entries and are kept in the same order as in a WMat.
+ *
+ * Entries are appended to a pending list by the Insert*() methods and
+ * merged into the sorted row arrays by Finalize(), which is also done
+ * automatically once the pending list has grown as large as the matrix.
+ * Entries with the same row and column are summed if they were inserted
+ * with InsertRowSumSingle(), otherwise they have to have the same value.
+ * The read access below is only valid after Finalize().
+ *
+ * The weights may optionally be held in single precision. Sums are always
+ * done in double precision within one Finalize().
+ */
+class WMatCSR {
+
+public:
+
+  typedef WMat::Entry Entry;
+
+  // row type used to migrate and unpack the matrix
+  typedef WMat::WeightMap::value_type Row;
+
+  WMatCSR(bool single_prec=false);
+
+  ~WMatCSR();
+
+  void swap(WMatCSR &rhs);
+
+  void InsertRow(const Entry &row, const std::vector<Entry> &cols);
+
+  void InsertRowMerge(const Entry &row, const std::vector<Entry> &cols);
+
+  void InsertRowMergeSingle(const Entry &row, const Entry &col);
+
+  void InsertRowSumSingle(const Entry &row, const Entry &col);
+
+  // Insert all entries of m, complain if an entry is already there with
+  // a different value
+  void InsertMerge(const WMatCSR &m);
+
+  // Merge the pending entries into the row arrays
+  void Finalize();
+
+  void clear();
+
+  // Read access
+  UInt num_rows() const { return row_id.size(); }
+  UInt num_entries() const { return col_id.size(); }
+
+  Entry row(UInt i) const {
+    return Entry(row_id[i], row_idx[i], 0.0, row_src_id[i]);
+  }
+  UInt row_begin(UInt i) const { return row_ptr[i]; }
+  UInt row_end(UInt i) const { return row_ptr[i+1]; }
+
+  Entry col(UInt k) const {
+    return Entry(col_id[k], col_idx[k], value(k), col_src_id[k]);
+  }
+  double value(UInt k) const {
+    return single_prec ? (double)val_sp[k] : val[k];
+  }
+
+  // Return the sum of the weights in row i
+  double row_sum(UInt i) const;
+
+  void GetRow(UInt i, Row &r) const;
+
+  void GetRowGIDS(std::vector<UInt> &gids);
+
+  std::pair<int, int> count_matrix_entries() const;
+
+  /*
+   * Remove any rows that have a mask value < 1 (if present).  Also remove any
+   * rows assigned to a node that is not locally owned.
+   */
+  void Prune(const Mesh &mesh, const MEField<_field> *mask=0);
+
+  /*
+   * Migrate the matrix to the row decomposition given by
+   * mesh.
+   */
+  void Migrate(Mesh &mesh);
+  void Migrate(PointList &plist);
+  void MigrateToElem(Mesh &mesh);
+
+  // Move all rows into wmat, releasing the storage here
+  void MoveToWMat(WMat &wmat);
+
+  // Iterator over the rows, used by the migration
+  class row_iterator {
+  public:
+    row_iterator() : mat(NULL), i(0), cur_i(-1) {}
+    row_iterator(const WMatCSR *_mat, UInt _i) : mat(_mat), i(_i), cur_i(-1) {}
+    row_iterator(const row_iterator &rhs) : mat(rhs.mat), i(rhs.i), cur_i(-1) {}
+    row_iterator &operator=(const row_iterator &rhs) {
+      mat=rhs.mat; i=rhs.i; cur_i=-1; return *this;
+    }
+    Row &operator*() const {
+      if (cur_i != (long)i) {mat->GetRow(i, cur); cur_i=i;}
+      return cur;
+    }
+    Row *operator->() const { return &(operator*()); }
+    row_iterator &operator++() { ++i; return *this; }
+    bool operator==(const row_iterator &rhs) const { return i == rhs.i; }
+    bool operator!=(const row_iterator &rhs) const { return i != rhs.i; }
+  private:
+    const WMatCSR *mat;
+    UInt i;
+    mutable long cur_i;
+    mutable Row cur;
+  };
+
+  row_iterator begin_row() const { return row_iterator(this, 0); }
+  row_iterator end_row() const { return row_iterator(this, num_rows()); }
+
+private:
+
+  // Pending entry, ops as below
+  enum {OP_MERGE=0, OP_SUM=1};
+  struct Pending {
+    UInt row_id, row_src_id;
+    UInt col_id, col_src_id;
+    double value;
+    UInt seq;
+    char row_idx, col_idx;
+    char op;
+    bool operator<(const Pending &rhs) const;
+  };
+
+  void append(const Entry &row, const Entry &col, char op);
+
+  bool single_prec;
+
+  // rows
+  std::vector<UInt> row_id, row_src_id;
+  std::vector<char> row_idx;
+  std::vector<UInt> row_ptr;
+
+  // columns
+  std::vector<UInt> col_id, col_src_id;
+  std::vector<char> col_idx;
+  std::vector<double> val;
+  std::vector<float> val_sp;
+
+  std::vector<Pending> pending;
+
+};
+
+// Migration Traits for WMatCSR
+
+template <>
+struct MigTraits<WMatCSR> {
+
+  typedef WMatCSR::row_iterator element_iterator;
+
+  typedef WMatCSR::Row element_type;
+
+  typedef SparsePack<element_type> element_pack;
+
+  static UInt element_pack_size(element_type &t) { return element_pack::size(t); }
+
+  typedef SparseUnpack<element_type> element_unpack;
+
+  static UInt get_id(element_type &t) { return t.first.id; }
+
+  static element_iterator element_begin(WMatCSR &t) { return t.begin_row(); }
+
+  static element_iterator element_end(WMatCSR &t) { return t.end_row(); }
+
+  static void insert_element(WMatCSR & t, UInt , element_type &el) { t.InsertRowMerge(el.first, el.second); }
+
+  static void resize_object(WMatCSR &, UInt) {}
+
+  static void clear_object(WMatCSR &t) { t.clear(); }
+
+};
+
+} // namespace
+
+#endif
@@ -76,6 +76,11 @@ namespace ESMCI {
     void *srcMaskValue;
     void *dstMaskValue;
     bool handleAllElements;
+    // file I/O of PET local streams, shared by RH files and RH cache files
+    static int writeFile(const std::string &file, const char *header,
+      int htype, const std::string &writeStreamiStr);
+    static int readFile(const std::string &file, const char *header,
+      int *htype, std::string &readStr, bool quiet=false);
    public:
     RouteHandle():ESMC_Base(-1){    // use Base constructor w/o BaseID increment
       // initialize the name for this RouteHandle object in the Base class
@@ -168,9 +173,21 @@ namespace ESMCI {
     
     // write RH to file
     int write(const std::string &file) const;
+    // RH cache files, holding the XXE, the additional storage, and the store
+    // parameters
+    int writeCache(const std::string &file, int srcTermProcessing,
+      int pipelineDepth) const;
+    static RouteHandle *readCache(const std::string &file,
+      int *srcTermProcessing, int *pipelineDepth, int *rc);
 
     // optimize for the communication pattern stored inside the RouteHandle
     int optimize() const;
+    // execute through a neighborhood collective where supported
+    int neighborReady() const;
+    // aggregate messages per pair of SSIs through shared memory
+    int aggregateReady() const;
+    // time alternative XXE encodings during the first executions
+    int tuneReady(int trialCount) const;
     bool isCompatible(Array *srcArrayArg, Array *dstArrayArg, int *rc=NULL)
       const;
   };   // class RouteHandle
@@ -287,7 +287,24 @@ namespace ESMCI {
     }
 
     void merge(const RegionNode &other) {
-      
+
+      //regions never exited, e.g. the ones above the first region
+      //of a thread, only bring their children
+      if (other.getCount() == 0) {
+        mergeChildren(other);
+        return;
+      }
+      if (_count == 0) {
+        _count = other.getCount();
+        _total = other.getTotal();
+        _min = other.getMin();
+        _max = other.getMax();
+        _mean = other.getMean();
+        _variance = other._variance;
+        mergeChildren(other);
+        return;
+      }
+
       size_t old_count = _count;
       double old_mean = _mean;
          
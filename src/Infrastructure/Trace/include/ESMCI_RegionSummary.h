@@ -12,6 +12,9 @@
 #define ESMCI_REGIONSUMMARY_H
 
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
 #include <vector>
 #include <math.h>
 #include <algorithm>
@@ -38,7 +41,18 @@ namespace ESMCI {
       _total_sum(0),
       _total_min(UINT64T_BIG), _total_min_pet(-1),
       _total_max(0), _total_max_pet(-1) {}
-    
+
+  RegionSummary(char *deserializeBuffer, size_t bufferSize):
+    _parent(NULL), _name(""),
+      _pet_count(0), _count_each(0), _counts_match(true),
+      _total_sum(0),
+      _total_min(UINT64T_BIG), _total_min_pet(-1),
+      _total_max(0), _total_max_pet(-1) {
+
+      size_t offset = 0;
+      deserialize(deserializeBuffer, &offset, bufferSize);
+    }
+
     ~RegionSummary() {
       while (!_children.empty()) {
         RegionSummary *toDel = _children.back();
@@ -177,8 +191,186 @@ namespace ESMCI {
       mergeChildren(rn, pet);
     }
 
+    /*
+     * Add the summary of another set of PETs to the summary,
+     * the PETs of other are expected to come after the ones
+     * already in the summary
+     */
+    void merge(const RegionSummary &other) {
+
+      if (other._pet_count > 0) {
+        if (_pet_count == 0) {
+          _count_each = other._count_each;
+          _counts_match = other._counts_match;
+        }
+        else if (!other._counts_match || _count_each != other._count_each) {
+          _counts_match = false;
+        }
+        _pet_count += other._pet_count;
+
+        _total_sum += other._total_sum;
+        if (_total_min > other._total_min) {
+          _total_min = other._total_min;
+          _total_min_pet = other._total_min_pet;
+        }
+        if (_total_max < other._total_max) {
+          _total_max = other._total_max;
+          _total_max_pet = other._total_max_pet;
+        }
+      }
+
+      //recursively merge child nodes
+      for (unsigned i = 0; i < other._children.size(); i++) {
+        RegionSummary *child = getOrAddChild(other._children.at(i)->getName());
+        child->merge(*(other._children.at(i)));
+      }
+    }
+
+    char *serialize(size_t *bufSize) {
+      size_t bufferSize = 0;
+      serializeSize(&bufferSize);
+      if (bufSize != NULL) *bufSize = bufferSize;
+
+      char *buffer = (char *) malloc(bufferSize);
+      if (buffer == NULL) {
+        throw std::bad_alloc();
+      }
+      memset(buffer, 0, bufferSize);
+
+      size_t offset = 0;
+      serialize(buffer, &offset, bufferSize);
+      return buffer;
+    }
+
   private:
 
+    /*
+     * serialize the tree to the byte array, each node followed
+     * by its children, and update offset to the end of the tree
+     */
+    void serialize(char *buffer, size_t *offset, size_t bufferSize) {
+
+      //align offset at 8 bytes
+      if (*offset % 8 > 0) {
+        *offset += (8 - (*offset % 8));
+      }
+
+      if (*offset + localSerializeSize() > bufferSize) {
+        std::stringstream errMsg;
+        errMsg << "Buffer too small to serialize region summary: ";
+        errMsg << "buffer size = " << bufferSize;
+        errMsg << " expected: " << (*offset + localSerializeSize());
+        throw std::runtime_error(errMsg.str());
+      }
+
+      size_t childCount = _children.size();
+      int countsMatch = _counts_match ? 1 : 0;
+      size_t nameSize = _name.length() + 1;
+
+      put(buffer, offset, &childCount, sizeof(childCount));
+      put(buffer, offset, &_pet_count, sizeof(_pet_count));
+      put(buffer, offset, &_count_each, sizeof(_count_each));
+      put(buffer, offset, &_total_sum, sizeof(_total_sum));
+      put(buffer, offset, &_total_min, sizeof(_total_min));
+      put(buffer, offset, &_total_max, sizeof(_total_max));
+      put(buffer, offset, &countsMatch, sizeof(countsMatch));
+      put(buffer, offset, &_total_min_pet, sizeof(_total_min_pet));
+      put(buffer, offset, &_total_max_pet, sizeof(_total_max_pet));
+      put(buffer, offset, &nameSize, sizeof(nameSize));
+      put(buffer, offset, _name.c_str(), nameSize);
+
+      for (unsigned i = 0; i < _children.size(); i++) {
+        _children.at(i)->serialize(buffer, offset, bufferSize);
+      }
+    }
+
+    void deserialize(char *buffer, size_t *offset, size_t bufferSize) {
+
+      //align offset at 8 bytes
+      if (*offset % 8 > 0) {
+        *offset += (8 - (*offset % 8));
+      }
+
+      size_t childCount = 0;
+      int countsMatch = 0;
+      size_t nameSize = 0;
+
+      get(buffer, offset, bufferSize, &childCount, sizeof(childCount));
+      get(buffer, offset, bufferSize, &_pet_count, sizeof(_pet_count));
+      get(buffer, offset, bufferSize, &_count_each, sizeof(_count_each));
+      get(buffer, offset, bufferSize, &_total_sum, sizeof(_total_sum));
+      get(buffer, offset, bufferSize, &_total_min, sizeof(_total_min));
+      get(buffer, offset, bufferSize, &_total_max, sizeof(_total_max));
+      get(buffer, offset, bufferSize, &countsMatch, sizeof(countsMatch));
+      get(buffer, offset, bufferSize, &_total_min_pet, sizeof(_total_min_pet));
+      get(buffer, offset, bufferSize, &_total_max_pet, sizeof(_total_max_pet));
+      get(buffer, offset, bufferSize, &nameSize, sizeof(nameSize));
+      _counts_match = (countsMatch == 1);
+
+      if (nameSize == 0 || *offset + nameSize > bufferSize ||
+          buffer[*offset + nameSize - 1] != '\0') {
+        throw std::runtime_error("Unexpected name when deserializing region summary.");
+      }
+      _name = string(buffer + *offset);
+      *offset += nameSize;
+
+      for (size_t i = 0; i < childCount; i++) {
+        RegionSummary *child = new RegionSummary(this);
+        _children.push_back(child);
+        child->deserialize(buffer, offset, bufferSize);
+      }
+    }
+
+    static void put(char *buffer, size_t *offset, const void *val, size_t len) {
+      memcpy(buffer + (*offset), val, len);
+      *offset += len;
+    }
+
+    static void get(char *buffer, size_t *offset, size_t bufferSize,
+                    void *val, size_t len) {
+      if (*offset + len > bufferSize) {
+        std::stringstream errMsg;
+        errMsg << "Buffer too small to deserialize region summary: ";
+        errMsg << "buffer size = " << bufferSize;
+        errMsg << " expected: " << (*offset + len);
+        throw std::runtime_error(errMsg.str());
+      }
+      memcpy(val, buffer + (*offset), len);
+      *offset += len;
+    }
+
+    /*
+     * returns length required to serialize this object
+     * not taking 8 byte alignment into account
+     */
+    size_t localSerializeSize() const {
+      return
+        sizeof(size_t) +  // number of children
+        sizeof(_pet_count) +
+        sizeof(_count_each) +
+        sizeof(_total_sum) +
+        sizeof(_total_min) +
+        sizeof(_total_max) +
+        sizeof(int) +  // counts match flag
+        sizeof(_total_min_pet) +
+        sizeof(_total_max_pet) +
+        sizeof(size_t) +  // records length of name
+        _name.length() + 1;  // length of name
+    }
+
+    /*
+     * returns size to serialize entire tree
+     */
+    void serializeSize(size_t *offset) const {
+      if (*offset % 8 > 0) {
+        *offset += (8 - (*offset % 8));
+      }
+      *offset += localSerializeSize();
+      for (unsigned i = 0; i < _children.size(); i++) {
+        _children.at(i)->serializeSize(offset);
+      }
+    }
+
     void mergeChildren(const RegionNode &other, int pet) {
       for (unsigned i = 0; i < other.getChildren().size(); i++) {
 	RegionSummary *child = getOrAddChild(other.getChildren().at(i)->getName());
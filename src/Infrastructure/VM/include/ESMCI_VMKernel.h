@@ -17,16 +17,16 @@
 #define MPICH_IGNORE_CXX_SEEK
 #endif
 
-#define USE_STRSTREAM
-
 #include <mpi.h>
 #include <vector>
 #include <string>
 #include <sstream>
-#ifdef USE_STRSTREAM
-#include <strstream>
-#endif
 #include <map>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <atomic>
 
 #ifdef VMK_STANDALONE
 #include <pthread.h>
@@ -73,13 +73,31 @@ enum vmEpoch  { epochNone=0, epochBuffer};
 #define VM_COMM_TYPE_PTHREAD  (1)
 #define VM_COMM_TYPE_SHMHACK  (2)
 #define VM_COMM_TYPE_POSIXIPC (3)
+#define VM_COMM_TYPE_CMA      (4)
+
+// - single-copy transfers between PETs on the same SSI, using Linux cross
+//   memory attach, for messages of at least VM_CMA_THRESHOLD bytes
+#if (defined ESMF_OS_Linux && !(defined ESMF_NO_MPI3 || defined ESMF_MPIUNI))
+#define VM_CMA_on
+#endif
+#define VM_CMA_THRESHOLD      (65536)
+#define VM_CMA_SEND           (0x1)   // peer can read from this PET
+#define VM_CMA_RECV           (0x2)   // this PET can read from peer
+#define VM_CMA_SEQ            (32768) // sequence numbers used as ack tags
+
+// - hierarchical collectives, staged through SSI shared scratch segments
+#if !(defined ESMF_NO_MPI3 || defined ESMF_MPIUNI)
+#define VM_COLL_on
+#endif
+#define VM_COLL_SCRATCH       (65536) // payload bytes per PET
+#define VM_COLL_HEADER        (64)    // sequence and flag ahead of payload
+#define VM_COLL_SPIN          (64)    // spins between yields
 
 // - VMKernel error code
 #define VMK_ERROR             (-1)
 
 // - buffer lenghts in bytes
 #define PIPC_BUFFER                   (4096)
-#define SHARED_BUFFER                 (64)
 
 // - number of shared memory non-blocking channels
 #define SHARED_NONBLOCK_CHANNELS      (16)
@@ -107,6 +125,42 @@ void sync_buffer_wait_empty(shmsync *shms, int select);
 void sync_reset(shmsync *shms);
 // end sync stuff -----
 
+// begin ring stuff -----
+#define VM_CACHE_LINE                 (64)
+#define VM_RING_SLOTS                 (8)     // default number of slots
+#define VM_RING_SLOT_SIZE             (4096)  // bytes per slot
+#define VM_RING_SPIN                  (1024)  // spins between yields
+typedef struct{
+  // Lock-free single producer single consumer ring of message slots. The
+  // sender only writes head and the receiver only writes tail, each on a
+  // cache line of its own, and each side keeps the last value it saw of
+  // the other index next to its own to avoid touching the shared line.
+  // written by the sender
+  std::atomic<unsigned long> head;  // number of slots filled so far
+  unsigned long tailCache;          // last tail seen by the sender
+  char pad1[VM_CACHE_LINE];
+  // written by the receiver
+  std::atomic<unsigned long> tail;  // number of slots emptied so far
+  unsigned long headCache;          // last head seen by the receiver
+  char pad2[VM_CACHE_LINE];
+  // fixed after ring_create()
+  int nslots;       // number of slots, each VM_RING_SLOT_SIZE bytes
+  int blocking;     // 0: spin, 1: sleep on cond while waiting
+  char *slots;      // cache line aligned slots
+  char *mem;        // allocation holding the slots
+  // blocking wait
+  std::atomic<int> sleepers;
+  esmf_pthread_mutex_t mutex;
+  esmf_pthread_cond_t cond;
+}shmring;
+
+shmring *ring_create(int nslots, int blocking);
+void ring_destroy(shmring *ring);
+void ring_send(shmring *ring, const void *message, int size);
+void ring_recv(shmring *ring, void *message, int size);
+int ring_capacity(shmring *ring);
+// end ring stuff -----
+
 
 namespace ESMCI {
 
@@ -116,11 +170,6 @@ namespace ESMCI {
 template<typename T> void append(std::stringstream &streami, T value){
   streami.write((char*)&value, sizeof(T));
 }
-#ifdef USE_STRSTREAM
-template<typename T> void append(std::strstream &streami, T value){
-  streami.write((char*)&value, sizeof(T));
-}
-#endif
 //-----------------------------------------------------------------------------
 
 
@@ -133,10 +182,39 @@ class VMK{
     commhandle *prev_handle;// previous handle in the queue
     commhandle *next_handle;// next handle in the queue
     int nelements;          // number of elements
-    int type;       // 0: commhandle container, 1: MPI_Requests, 2: ... reserved
+    int type;       // 0: commhandle container, 1: MPI_Requests,
+                    // 2: persistent MPI_Request, 3: shared collective
+                    // MPI_Request not owned by the commhandle,
+                    // 4: single-copy transfer, -1: dummy
     bool sendFlag;          // true if this is a send request
     commhandle **handles;   // sub handles
     MPI_Request *mpireq;    // request array
+    // binding of a persistent request (type 2)
+    void *pBuffer;
+    int pSize;
+    int pPeer;
+    int pTag;
+    // single-copy transfer (type 4), buffer and peer are held in p* above
+    long cmaMsg[4];         // header: pid, address, size, sequence number
+    int cmaAck;             // acknowledgement, 0 if the transfer succeeded
+    bool cmaDone;           // receive side: header arrived and data read
+    MPI_Status cmaStatus;   // receive side: status of the header
+   public:
+    commhandle(){  // native constructor
+      prev_handle = NULL;
+      next_handle = NULL;
+      nelements = 0;
+      type = -1;
+      sendFlag = false;
+      handles = NULL;
+      mpireq = NULL;
+      pBuffer = NULL;
+      pSize = -1;
+      pPeer = -1;
+      pTag = -1;
+      cmaAck = 0;
+      cmaDone = false;
+    }
   };
 
   struct memhandle{
@@ -178,24 +256,15 @@ class VMK{
   };
 
   struct shared_mp{
-    // source and destination pointers
-    volatile const void *ptr_src;
-    volatile void *ptr_dst;
-    volatile int tcounter;
+    // ring for blocking messages
+    shmring *ring;
     // non-blocking channels
     volatile const void *ptr_src_nb[SHARED_NONBLOCK_CHANNELS];
     volatile void *ptr_dst_nb[SHARED_NONBLOCK_CHANNELS];
     int recvCount;
     int sendCount;
-    // hack sync variables
+    // hack sync variables for the barriers
     shmsync shms;
-    // buffer for small messages
-    char buffer[SHARED_BUFFER];
-    // Pthread sync variables
-    esmf_pthread_mutex_t mutex1;
-    esmf_pthread_cond_t cond1;
-    esmf_pthread_mutex_t mutex2;
-    esmf_pthread_cond_t cond2;
   };
 
   struct comminfo{
@@ -211,29 +280,82 @@ class VMK{
     ipshmAlloc *next;   // pointer to next ipshmAlloc element in list
   };
   
+  struct epochArena{
+    // Raw storage for epoch messages. Unlike std::vector::resize() growing
+    // does not value-initialize the new bytes, which would only be
+    // overwritten by the following memcpy() or MPI_Recv() anyway.
+    char *data;
+    size_t capacity;
+   public:
+    epochArena(){data = NULL; capacity = 0;}
+    ~epochArena(){release();}
+    epochArena(const epochArena &) = delete;
+    epochArena &operator=(const epochArena &) = delete;
+    void grow(size_t bytes, size_t keepBytes){
+      // ensure capacity for bytes, preserving the first keepBytes of data
+      if (bytes <= capacity) return;
+      size_t newCapacity = std::max(bytes, 2*capacity);
+      char *newData;
+      if (keepBytes > 0)
+        newData = (char *)realloc(data, newCapacity);
+      else{
+        free(data);
+        data = NULL;
+        capacity = 0;
+        newData = (char *)malloc(newCapacity);
+      }
+      if (newData == NULL) throw std::bad_alloc();
+      data = newData;
+      capacity = newCapacity;
+    }
+    void release(){
+      free(data);
+      data = NULL;
+      capacity = 0;
+    }
+  };
+
   struct sendBuffer{
-#ifdef USE_STRSTREAM
-    std::strstream stream;
-#else
-    std::stringstream stream;
-    std::string streamBuffer;
-#endif
-    MPI_Request mpireq;
+    // The arena persists across epochs. It is only ever grown, never shrunk,
+    // so after the first epoch messages are appended without reallocation,
+    // and the same memory is handed to MPI every time.
+    epochArena arena;
+    size_t size;          // bytes appended during the current epoch
+    MPI_Request mpireq;   // persistent send request bound to the arena
+    void *reqBuffer;      // buffer mpireq is bound to
+    int reqSize;          // message size mpireq is bound to
+    int reqDest;          // rank mpireq is bound to
+    bool activeFlag;      // true while mpireq is started and not completed
     bool firstFlag;
    public:
     sendBuffer(){  // native constructor
+      size = 0;
       mpireq = MPI_REQUEST_NULL;
+      reqBuffer = NULL;
+      reqSize = -1;
+      reqDest = -1;
+      activeFlag = false;
       firstFlag = true;
     }
+    void append(const void *data, size_t bytes){
+      arena.grow(size+bytes, size);
+      memcpy(arena.data+size, data, bytes);
+      size += bytes;
+    }
+    void post(int dest, int tag, MPI_Comm comm);
     void clear();
+    void release();
   };
     
   struct recvBuffer{
-    std::string streamBuffer;
+    // The per-peer entry persists across epochs. The arena is only ever
+    // grown, unless released by epochExit(keepAlloc=false).
+    epochArena arena;
     void *buffer;
     bool firstFlag;
    public:
     recvBuffer(){  // native constructor
+      buffer = NULL;
       firstFlag = true;
     }
   };
@@ -288,6 +410,34 @@ class VMK{
     bool pastFirst; // true if the first epoch enabled call has been made
     std::map<int, sendBuffer> sendMap;
     std::map<int, recvBuffer> recvMap;
+    // Single-copy transfers
+    char *cmaPeer;      // VM_CMA_SEND|VM_CMA_RECV bits for each PET
+    int *cmaSeq;        // last sequence number sent to each PET
+    std::vector<commhandle *> cmaPending; // receives waiting for a header
+#ifdef VM_CMA_on
+    MPI_Comm mpi_c_cma;     // headers, using the tag of the message
+    MPI_Comm mpi_c_cma_ack; // acknowledgements, using the sequence number
+#endif
+    // Node-aware aggregation of XXE exchanges
+    MPI_Comm mpi_c_agg; // leader messages of all XXEs, created on first use
+    // Hierarchical collectives
+    bool collHier;      // use hierarchical collectives where possible
+    int collState;      // 0: not set up, 1: ready, -1: not available
+    memhandle collMemh; // shared scratch segments on the local SSI
+    std::vector<char *> collSeg;  // segment of each SSI-local PET by SSI rank
+    std::vector<int> collPetRank; // SSI rank of each PET, -1 if not local
+    std::vector<int> collNode;    // node (leader rank) of each PET
+    std::vector<int> collOrder;   // PETs sorted by node, then by PET
+    std::vector<int> collNodeStart; // first collOrder index of each node
+    int collRank;       // SSI rank of this PET, the node leader is rank 0
+    int collNodeCount;  // number of nodes, i.e. of node leaders
+    unsigned long collSeq;    // number of hierarchical collectives so far
+    unsigned long collBytes;  // payload bytes of each segment
+    unsigned long collResultBytes;    // bytes of the leader result area
+    unsigned long collMinResultBytes; // smallest result area across nodes
+#ifdef VM_COLL_on
+    MPI_Comm mpi_c_coll;  // communicator between the node leaders
+#endif
     // static info of physical machine
     static int nssiid;  // total number of single system image ids
     static int ncores;  // total number of cores in the physical machine
@@ -330,6 +480,23 @@ class VMK{
     void obtain_args();
     void commqueueitem_link(commhandle *commh);
     int  commqueueitem_unlink(commhandle *commh);
+    void cmaInit();
+    void cmaFinal();
+    void cmaProgress();
+    void cmaRead(commhandle *commh);
+    void collInit();
+    void collFinal();
+    bool collReady();
+    void aggFinal();
+#ifdef VM_COLL_on
+    int allreduceHier(void *in, void *out, int len, vmType type, vmOp op,
+      MPI_Datatype mpitype, MPI_Op mpiop);
+    int allgathervHier(void *in, void *out, int *outCounts, int *outOffsets,
+      int size);
+    int alltoallvHier(void *in, int *inCounts, int *inOffsets, void *out,
+      int *outCounts, int *outOffsets, int size, MPI_Datatype mpitype);
+    int broadcastHier(void *data, int len, int root);
+#endif
   public:
     static void InitPreMPI();
       // initialization step before MPI is initialized
@@ -367,6 +534,7 @@ class VMK{
     int getNadevs(int i);          // return nadevs
     int getSsi(int i);             // return ssiid
     MPI_Comm getMpi_c();           // return mpi_c
+    MPI_Comm getMpi_c_agg();       // return mpi_c_agg, collective on 1st call
     int getNthreads(int i);        // return number of threads in group PET
     int getTid(int i);             // return tid for PET
     int getVas(int i);             // return vas for PET
@@ -378,6 +546,7 @@ class VMK{
     // get() calls
     int getLocalPet() const {return mypet;}
     int getCurrentSsiPe() const;
+    int getLocalThreadCount() const;
     int getPetCount() const {return npets;}
     int getSsiCount() const {return ssiCount;}
     int getSsiMinPetCount() const {return ssiMinPetCount;}
@@ -480,7 +649,31 @@ class VMK{
     void commqueuewait();
     void commcancel(commhandle **commh);
     bool cancelled(status *status);
+
+    // persistent p2p communication calls
+    int sendinit(const void *message, int size, int dest, commhandle **commh,
+      int tag=-1);
+    int recvinit(void *message, int size, int source, commhandle **commh,
+      int tag=-1);
+    int commstart(commhandle **commh);
+    void commfree(commhandle **commh);
+    static void commdrop(commhandle **commh);
+
+    // single-copy p2p communication calls
+    bool cmaok(int size, int peer, bool sendFlag){
+      // true if a message of size bytes goes to/comes from peer by single-copy
+      return (size >= VM_CMA_THRESHOLD) && (epoch != epochBuffer)
+        && (peer >= 0) && (cmaPeer[peer] & (sendFlag ? VM_CMA_SEND : VM_CMA_RECV));
+    }
+    int sendcma(const void *message, int size, int dest, commhandle **commh,
+      int tag=-1);
+    int recvcma(void *message, int size, int source, commhandle **commh,
+      int tag=-1);
     
+    // hierarchical collectives, must be set the same on all PETs of the VM
+    void setCollHier(bool flag){collHier = flag;}
+    bool getCollHier()const{return collHier;}
+
     // SSI shared memory methods
     int ssishmAllocate(std::vector<unsigned long>&bytes, memhandle *memh,
       bool contigFlag=false);
@@ -544,6 +737,10 @@ class VMKPlan{
     int pref_intra_process;     // default: PREF_INTRA_PROCESS_SHMHACK
     int pref_intra_ssi;         // default: PREF_INTRA_SSI_POSIXIPC
     int pref_inter_ssi;         // defualt: PREF_INTER_SSI_MPI1
+    // number of ring slots per intra-process PET pair
+    int ring_slots;             // default: VM_RING_SLOTS
+    // hierarchical collectives in the new VMs
+    bool coll_hier;             // default: false
     // MPI communicator for the participating PET group of parent VM
     int *lpid_mpi_g_part_map;
     MPI_Comm mpi_c_part;
@@ -614,6 +811,10 @@ class VMKPlan{
       // set up a VMKPlan that will have pets with the maximum number of
       // cores available, but not more than max and only use PETs listed in
       // plist
+    void vmkplan_ringslots(int nslots);
+      // set the number of ring slots for intra-process messages
+    void vmkplan_collhier(bool flag);
+      // select hierarchical collectives for the new VMs
     void vmkplan_print();  
 
   friend class VMK;